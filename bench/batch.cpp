@@ -0,0 +1,114 @@
+#include "bench.h"
+#include <types/batch.h>
+#include <vector>
+
+//Batch (types/batch.h) against looping over TMatrix::operator*
+//Points and normals are transformed from SoA streams by Batch and from Vec4f arrays by the loop
+
+using namespace oi;
+using namespace oi::bench;
+
+static Matrixf makeMatrix(u32 i) {
+	return Matrixf::makeModel(Vec3f((f32) i, 2, 3), Vec3f(30, (f32) i, 10), Vec3f(1, 2, 1));
+}
+
+static void transforms(u32 count) {
+
+	Matrixf m = makeMatrix(1);
+
+	std::vector<Vec4f> aos(count), aosOut(count);
+	std::vector<f32> x(count), y(count), z(count), ox(count), oy(count), oz(count);
+
+	for (u32 i = 0; i < count; ++i) {
+		x[i] = (f32) i; y[i] = (f32)(i & 7); z[i] = 1;
+		aos[i] = Vec4f(x[i], y[i], z[i], 1);
+	}
+
+	u64 iterations = 64 * 1024 * 1024 / ((u64) count * 16) + 1;
+
+	double loop = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j) {
+			for (u32 i = 0; i < count; ++i)
+				aosOut[i] = m * aos[i];
+			keep(aosOut[j % count]);
+		}
+	});
+
+	double points = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j) {
+			Batch::transformPoints(m, x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), count);
+			keep(ox[j % count]);
+		}
+	});
+
+	double normals = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j) {
+			Batch::transformNormals(m, x.data(), y.data(), z.data(), ox.data(), oy.data(), oz.data(), count);
+			keep(ox[j % count]);
+		}
+	});
+
+	printf("Transform %u points/normals\n", count);
+	report("  Matrixf * Vec4f per element", loop / count);
+	report("  Batch::transformPoints", points / count, loop / count);
+	report("  Batch::transformNormals", normals / count, loop / count);
+}
+
+static void multiplies(u32 count) {
+
+	std::vector<Matrixf> a(count), b(count), res(count);
+
+	for (u32 i = 0; i < count; ++i) {
+		a[i] = makeMatrix(i);
+		b[i] = makeMatrix(i + 1);
+	}
+
+	u64 iterations = 64 * 1024 * 1024 / ((u64) count * 64) + 1;
+
+	double loop = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j) {
+			for (u32 i = 0; i < count; ++i)
+				res[i] = a[i] * b[i];
+			keep(res[j % count]);
+		}
+	});
+
+	double batch = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j) {
+			Batch::multiply(a.data(), b.data(), res.data(), count);
+			keep(res[j % count]);
+		}
+	});
+
+	double parentLoop = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j) {
+			for (u32 i = 0; i < count; ++i)
+				res[i] = a[0] * b[i];
+			keep(res[j % count]);
+		}
+	});
+
+	double parent = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j) {
+			Batch::multiply(a[0], b.data(), res.data(), count);
+			keep(res[j % count]);
+		}
+	});
+
+	printf("Multiply %u matrices\n", count);
+	report("  a[i] * b[i] per element", loop / count);
+	report("  Batch::multiply", batch / count, loop / count);
+	report("  a * b[i] per element", parentLoop / count);
+	report("  Batch::multiply (one parent)", parent / count, parentLoop / count);
+}
+
+int main() {
+
+	transforms(1024);
+	transforms(100 * 1000);
+
+	multiplies(1024);
+	multiplies(100 * 1000);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <types/generic.h>
+#include <chrono>
+#include <cstdio>
+
+//Tiny timing helpers for the standalone benchmarks in bench/
+//Every benchmark is one translation unit against the headers; see bench/README.md for how to build and run them
+
+namespace oi {
+
+	namespace bench {
+
+		//Keeps the optimizer from removing the benchmarked work
+		template<typename T>
+		inline void keep(const T &t) {
+			static volatile const void *sink;
+			sink = &t;
+			(void) sink;
+		}
+
+		//Runs f(iterations) 'runs' times; returns the fastest run in ns per iteration
+		template<typename F>
+		inline double measure(u64 iterations, F f, u32 runs = 7) {
+
+			double best = 1e300;
+
+			for (u32 i = 0; i < runs; ++i) {
+
+				auto start = std::chrono::high_resolution_clock::now();
+				f(iterations);
+				auto end = std::chrono::high_resolution_clock::now();
+
+				double ns = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double) iterations;
+
+				if (ns < best)
+					best = ns;
+			}
+
+			return best;
+		}
+
+		//Prints a result; relative to a baseline (in ns per iteration) if it isn't 0
+		inline void report(const char *name, double ns, double baseline = 0) {
+
+			if (baseline == 0)
+				printf("%-48s %12.2f ns\n", name, ns);
+			else
+				printf("%-48s %12.2f ns %8.2fx\n", name, ns, baseline / ns);
+		}
+
+	}
+
+}
\ No newline at end of file
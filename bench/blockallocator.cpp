@@ -0,0 +1,132 @@
+#include "bench.h"
+#include <memory/blockallocator.h>
+#include <algorithm>
+#include <vector>
+
+//Allocation churn of TLSFAllocator against a linear scan allocator
+//The linear scan allocator works like VirtualBlockAllocator; free ranges and allocations are vectors that are searched, erased from and merged linearly
+
+using namespace oi;
+using namespace oi::bench;
+
+class LinearAllocator {
+
+public:
+
+	LinearAllocator(u32 length) { blocks.push_back({ 0, length }); }
+
+	BlockAllocation alloc(u32 size) {
+
+		for (u32 i = 0; i < (u32) blocks.size(); ++i)
+			if (blocks[i].size >= size) {
+
+				BlockAllocation res = { blocks[i].start, size };
+
+				blocks[i].start += size;
+				blocks[i].size -= size;
+
+				if (blocks[i].size == 0)
+					blocks.erase(blocks.begin() + i);
+
+				allocations.push_back(res);
+				return res;
+			}
+
+		return { 0, 0 };
+	}
+
+	bool dealloc(u32 pos) {
+
+		for (u32 i = 0; i < (u32) allocations.size(); ++i)
+			if (allocations[i].start == pos) {
+				BlockAllocation allocation = allocations[i];
+				allocations.erase(allocations.begin() + i);
+				merge(allocation);
+				return true;
+			}
+
+		return false;
+	}
+
+private:
+
+	//Free ranges are sorted by start; merges with the neighbouring ranges
+	void merge(BlockAllocation allocation) {
+
+		u32 i = 0;
+
+		while (i < (u32) blocks.size() && blocks[i].start < allocation.start)
+			++i;
+
+		blocks.insert(blocks.begin() + i, allocation);
+
+		if (i + 1 < (u32) blocks.size() && blocks[i].end() == blocks[i + 1].start) {
+			blocks[i].size += blocks[i + 1].size;
+			blocks.erase(blocks.begin() + i + 1);
+		}
+
+		if (i > 0 && blocks[i - 1].end() == blocks[i].start) {
+			blocks[i - 1].size += blocks[i].size;
+			blocks.erase(blocks.begin() + i);
+		}
+	}
+
+	std::vector<BlockAllocation> blocks, allocations;
+
+};
+
+//Keeps 'live' allocations (16 B - 64 KiB, like streamed vertex and index ranges) and replaces a random one every operation
+template<typename T>
+static double churn(u32 live, u64 operations, f32 *fragmentation = nullptr) {
+
+	return measure(operations, [&](u64 n) {
+
+		T allocator(1U << 30);
+		std::vector<u32> allocations;
+
+		u32 seed = 1;
+
+		auto size = [&seed]() -> u32 {
+			seed = seed * 1664525U + 1013904223U;
+			return 16U << ((seed >> 8) % 13);
+		};
+
+		for (u32 i = 0; i < live; ++i)
+			allocations.push_back(allocator.alloc(size()).start);
+
+		for (u64 i = 0; i < n; ++i) {
+
+			seed = seed * 1664525U + 1013904223U;
+			u32 &slot = allocations[(seed >> 4) % live];
+
+			allocator.dealloc(slot);
+			slot = allocator.alloc(size()).start;
+		}
+
+		keep(allocations[0]);
+
+		if constexpr (std::is_same<T, TLSFAllocator>::value)
+			if (fragmentation)
+				*fragmentation = allocator.getFragmentation();
+
+	}, 3);
+}
+
+int main() {
+
+	for (u32 live : { 1000U, 10000U, 50000U }) {
+
+		u64 operations = 200000000ULL / ((u64) live * 8) + 1000;
+		f32 fragmentation = 0;
+
+		double linear = churn<LinearAllocator>(live, operations);
+		double tlsf = churn<TLSFAllocator>(live, operations * 10, &fragmentation);
+
+		printf("%u live allocations; dealloc + alloc\n", live);
+		report("  Linear scan (VirtualBlockAllocator)", linear);
+		report("  TLSFAllocator", tlsf, linear);
+		printf("  TLSFAllocator fragmentation afterwards: %.3f\n", fragmentation);
+	}
+
+	return 0;
+}
\ No newline at end of file
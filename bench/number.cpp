@@ -0,0 +1,104 @@
+#include "bench.h"
+#include <types/number.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//Number formatting and parsing (types/number.h) against the std::stringstream path of String::fromNumber, toLong and toFloat
+
+using namespace oi;
+using namespace oi::bench;
+
+//keep only takes the address; parsed values are stored, so the parse can't be removed
+static volatile f64 parsed;
+
+template<typename T>
+static void format(const char *name, const std::vector<T> &values) {
+
+	u64 iterations = 64;
+
+	double ss = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j)
+			for (const T &t : values) {
+				std::stringstream stream;
+				stream << t;
+				std::string str = stream.str();
+				keep(str);
+			}
+	});
+
+	double number = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j)
+			for (const T &t : values) {
+				char tmp[Number::maxChars];
+				std::string str(tmp, Number::format(t, tmp));
+				keep(str);
+			}
+	});
+
+	printf("Format %s\n", name);
+	report("  std::stringstream", ss / values.size());
+	report("  Number::format", number / values.size(), ss / values.size());
+}
+
+template<typename T>
+static void parse(const char *name, const std::vector<std::string> &values) {
+
+	u64 iterations = 64;
+
+	double ss = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j)
+			for (const std::string &str : values) {
+				std::stringstream stream(str);
+				T t = 0;
+				stream >> t;
+				parsed = (f64) t;
+			}
+	});
+
+	double number = measure(iterations, [&](u64 n) {
+		for (u64 j = 0; j < n; ++j)
+			for (const std::string &str : values) {
+				T t = 0;
+				Number::parse(str.data(), (u32) str.size(), t);
+				parsed = (f64) t;
+			}
+	});
+
+	printf("Parse %s\n", name);
+	report("  std::stringstream", ss / values.size());
+	report("  Number::parse", number / values.size(), ss / values.size());
+}
+
+int main() {
+
+	std::vector<i32> ints;
+	std::vector<f32> floats;
+	std::vector<f64> doubles;
+
+	u32 seed = 1;
+
+	for (u32 i = 0; i < 4096; ++i) {
+		seed = seed * 1664525U + 1013904223U;
+		ints.push_back((i32) seed >> (seed & 15));
+		floats.push_back((f32)(i32) seed / 65536.f);
+		doubles.push_back((f64)(i32) seed / 1048576.0);
+	}
+
+	format("i32", ints);
+	format("f32", floats);
+	format("f64", doubles);
+
+	std::vector<std::string> intText, floatText;
+
+	for (u32 i = 0; i < 4096; ++i) {
+		intText.push_back(std::to_string(ints[i]));
+		floatText.push_back(std::to_string(doubles[i]));
+	}
+
+	parse<i64>("i64", intText);
+	parse<f32>("f32", floatText);
+	parse<f64>("f64", floatText);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "bench.h"
+#include <types/simd.h>
+#include <vector>
+
+//ShaderBufferWriter::setArray repacking; tightly packed CPU arrays into std140/std430 array strides
+//Compares the per element memcpy (with a runtime size) that setArray used to do with StridedOps::copy
+
+using namespace oi;
+using namespace oi::bench;
+
+struct Vec3f { f32 x, y, z; };
+struct Vec2f { f32 x, y; };
+
+//The old setArray loop; the size comes from the layout so it isn't a constant
+static void copyPerElement(u8 *dst, const void *src, u32 count, u32 size, u32 stride) {
+	for (u32 i = 0; i < count; ++i)
+		memcpy(dst + (size_t) i * stride, (const u8*) src + (size_t) i * size, size);
+}
+
+template<typename T>
+static void run(const char *name, u32 count, u32 stride) {
+
+	std::vector<T> src(count);
+	std::vector<u8> dst((size_t) count * stride);
+
+	for (u32 i = 0; i < count * (u32) sizeof(T) / 4; ++i)
+		((f32*) src.data())[i] = (f32) i;
+
+	volatile u32 size = (u32) sizeof(T);
+	u64 iterations = 64 * 1024 * 1024 / ((u64) count * stride) + 1;
+
+	double old = measure(iterations, [&](u64 n) {
+		for (u64 i = 0; i < n; ++i) {
+			copyPerElement(dst.data(), src.data(), count, size, stride);
+			keep(dst[i % dst.size()]);
+		}
+	});
+
+	double strided = measure(iterations, [&](u64 n) {
+		for (u64 i = 0; i < n; ++i) {
+			StridedOps<T>::copy(dst.data(), src.data(), count, stride);
+			keep(dst[i % dst.size()]);
+		}
+	});
+
+	printf("%s; %u elements of %u bytes to a stride of %u\n", name, count, (u32) sizeof(T), stride);
+	report("  memcpy per element", old);
+	report("  StridedOps::copy", strided, old);
+}
+
+int main() {
+
+	run<Vec3f>("vec3[]", 256, 16);
+	run<Vec3f>("vec3[]", 64 * 1024, 16);
+
+	run<f32>("float[] (std140)", 256, 16);
+	run<f32>("float[] (std140)", 64 * 1024, 16);
+
+	run<Vec2f>("vec2[] (std140)", 64 * 1024, 16);
+
+	return 0;
+}
\ No newline at end of file
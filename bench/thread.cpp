@@ -0,0 +1,67 @@
+#include "bench.h"
+#include <types/thread.h>
+#include <future>
+#include <cmath>
+
+//Thread::foreachCore on the persistent task scheduler against the std::async version it replaced (a thread per core per call)
+
+using namespace oi;
+using namespace oi::bench;
+
+static void foreachCoreAsync(std::function<void (u32)> f) {
+
+	u32 threads = Thread::cores();
+	std::vector<std::future<void>> thr(threads);
+
+	for (u32 i = 0; i < threads; ++i)
+		thr[i] = std::async(f, i);
+
+	for (u32 i = 0; i < threads; ++i)
+		thr[i].get();
+}
+
+//'work' iterations of dependent math per core
+static f64 spin(u32 i, u32 work) {
+
+	f64 x = i + 1.0;
+
+	for (u32 j = 0; j < work; ++j)
+		x = std::sqrt(x + j);
+
+	return x;
+}
+
+int main() {
+
+	printf("%u cores\n", Thread::cores());
+
+	for (u32 work : { 0U, 1000U, 100000U }) {
+
+		//One slot per core; so the results aren't a data race and the checksum keeps the work alive
+		std::vector<f64> results(Thread::cores());
+		u64 calls = work >= 100000 ? 20 : 2000;
+
+		double async = measure(calls, [work, &results](u64 n) {
+			for (u64 i = 0; i < n; ++i)
+				foreachCoreAsync([work, &results](u32 core) { results[core] += spin(core, work); });
+		}, 3);
+
+		double scheduler = measure(calls, [work, &results](u64 n) {
+			for (u64 i = 0; i < n; ++i)
+				Thread::foreachCore([work, &results](u32 core) { results[core] += spin(core, work); });
+		}, 3);
+
+		printf("foreachCore with %u iterations per core\n", work);
+		report("  std::async per core", async);
+		report("  TaskScheduler", scheduler, async);
+
+		f64 checksum = 0;
+
+		for (f64 r : results)
+			checksum += r;
+
+		printf("  checksum %f\n", checksum);
+	}
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <types/generic.h>
+#include <algorithm>
+#include <vector>
+
+namespace oi {
+
+	namespace gc {
+
+		//Byte range [start, end)
+		struct DirtyRange {
+
+			u32 start, end;
+
+			u32 size() const { return end - start; }
+
+		};
+
+		//Keeps track of modified byte ranges; so only those have to be uploaded
+		//Ranges that are closer than 'gap' bytes are merged; one bigger copy is cheaper than many tiny ones
+		class DirtyRanges {
+
+		public:
+
+			DirtyRanges(u32 gap = 64U) : gap(gap) {}
+
+			void add(u32 offset, u32 length);
+			void clear() { ranges.clear(); sorted = true; }
+
+			bool empty() const { return ranges.empty(); }
+
+			const std::vector<DirtyRange> &get();		//Sorted and coalesced
+			u32 getBytes();								//Bytes that have to be uploaded
+
+		private:
+
+			void coalesce();
+
+			std::vector<DirtyRange> ranges;
+			bool sorted = true;
+			u32 gap;
+
+		};
+
+		inline void DirtyRanges::add(u32 offset, u32 length) {
+
+			if (length == 0)
+				return;
+
+			u32 end = offset + length;
+
+			//Writes are usually sequential; so try to extend the last range first
+			if (!ranges.empty()) {
+
+				DirtyRange &last = ranges.back();
+
+				if (offset <= last.end + gap && end + gap >= last.start) {
+					last.start = std::min(last.start, offset);
+					last.end = std::max(last.end, end);
+
+					if (ranges.size() > 1 && last.start < ranges[ranges.size() - 2].start)
+						sorted = false;
+
+					return;
+				}
+
+				if (offset < last.start)
+					sorted = false;
+			}
+
+			ranges.push_back({ offset, end });
+		}
+
+		inline void DirtyRanges::coalesce() {
+
+			if (!sorted)
+				std::sort(ranges.begin(), ranges.end(), [](const DirtyRange &a, const DirtyRange &b) -> bool { return a.start < b.start; });
+
+			sorted = true;
+
+			if (ranges.size() < 2)
+				return;
+
+			u32 j = 0;
+
+			for (u32 i = 1; i < (u32) ranges.size(); ++i) {
+
+				if (ranges[i].start <= ranges[j].end + gap)
+					ranges[j].end = std::max(ranges[j].end, ranges[i].end);
+				else
+					ranges[++j] = ranges[i];
+			}
+
+			ranges.resize(j + 1);
+		}
+
+		inline const std::vector<DirtyRange> &DirtyRanges::get() {
+			coalesce();
+			return ranges;
+		}
+
+		inline u32 DirtyRanges::getBytes() {
+
+			u32 bytes = 0;
+
+			for (const DirtyRange &range : get())
+				bytes += range.size();
+
+			return bytes;
+		}
+
+	}
+
+}
\ No newline at end of file
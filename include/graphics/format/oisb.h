@@ -1,6 +1,11 @@
 #pragma once
 
 #include <template/enum.h>
+#include <types/buffer.h>
+#include <utils/log.h>
+#include <utils/hash.h>
+#include <string_view>
+#include <cstring>
 
 namespace oi {
 
@@ -69,6 +74,42 @@ namespace oi {
 
 		};
 
+		enum class SBPathFlag : u8 {
+			NONE = 0x0U,
+			USED = 0x1U,		//Slot contains a path
+			IS_STRUCT = 0x2U
+		};
+
+		//Precomputed member path, stored in a hash table (power of two slots, linear probing)
+		//The hash is of the path relative to the buffer, without array indices; "lights/3/color" is stored as "lights/color"
+		struct SBPath {
+
+			u32 hash;			//Hash::fnv1a
+			u32 offset;			//Offset of the first element (from the start of the buffer)
+
+			u32 length;			//Size of one element
+			u32 stride;			//Bytes between (flattened) array elements
+
+			u32 arraySize;		//0 if it's unbounded (runtime array)
+
+			u16 element;		//Element id in ShaderBufferInfo; 0 is the buffer itself (self), i is elements[i - 1]
+			u8 flags;			//SBPathFlag
+			u8 type;			//TextureFormat
+
+		};
+
+		//Bytes of a buffer that a stage accesses (per member; Compiler::get_active_buffer_ranges)
+		//Sorted and coalesced per stage
+		struct SBActiveRange {
+
+			u32 offset;
+			u32 size;
+
+			u8 stage;			//ShaderRegisterAccess of the stage
+			u8 padding[3];
+
+		};
+
 		struct SBFile {
 
 			SBHeader header;
@@ -92,7 +133,211 @@ namespace oi {
 
 			static Buffer write(SBFile file);					//Creates new buffer
 			static bool write(String path, SBFile file);
+
+			//Layout: SBHeader, SBStruct[structs], SBVar[vars]
+			static u32 getSize(const SBFile &file);
+			static u32 write(const SBFile &file, Buffer target);		//Writes into target; returns size or 0 if it doesn't fit
+
+			//Turns a list of paths into a hash table; fails on hash collisions
+			static bool makePaths(const std::vector<SBPath> &paths, std::vector<SBPath> &table);
+
+			//Validates a table that was read from a file; it needs power of two slots with at least one empty slot and its paths inside the buffer
+			//size is the declared size of the buffer; a runtime array can extend it by one element
+			static bool checkPaths(const std::vector<SBPath> &table, u32 size);
+
+			//Finds the path and adds the offsets of the array indices; "lights/3/color"
+			//Multi dimensional arrays take one flattened index (row major); a[1][2] of T a[3][4] is "a/6"
+			//Returns nullptr if the path doesn't exist, an index is out of bounds or a member has multiple indices
+			//Indices into runtime arrays aren't bounded; the caller checks them against the size of the buffer
+			static const SBPath *findPath(const std::vector<SBPath> &table, std::string_view path, u32 &offset);
+
+		private:
+
+			static const SBPath *probePath(const std::vector<SBPath> &table, u32 hash);
+
 		};
 
+		inline u32 oiSB::getSize(const SBFile &file) {
+			return (u32)(sizeof(SBHeader) + file.structs.size() * sizeof(SBStruct) + file.vars.size() * sizeof(SBVar));
+		}
+
+		inline u32 oiSB::write(const SBFile &file, Buffer target) {
+
+			u32 size = getSize(file);
+
+			if (target.size() < size)
+				return Log::error("oiSB::write; target buffer is too small");
+
+			if (file.structs.size() > u16_MAX || file.vars.size() > u16_MAX)
+				return Log::error("oiSB::write; too many elements for the SBHeader");
+
+			SBHeader header = file.header;
+			header.structs = (u16) file.structs.size();
+			header.vars = (u16) file.vars.size();
+
+			u8 *ptr = target.addr();
+
+			memcpy(ptr, &header, sizeof(header));
+			ptr += sizeof(header);
+
+			if (!file.structs.empty())
+				memcpy(ptr, file.structs.data(), file.structs.size() * sizeof(SBStruct));
+
+			ptr += file.structs.size() * sizeof(SBStruct);
+
+			if (!file.vars.empty())
+				memcpy(ptr, file.vars.data(), file.vars.size() * sizeof(SBVar));
+
+			return size;
+		}
+
+		inline bool oiSB::makePaths(const std::vector<SBPath> &paths, std::vector<SBPath> &table) {
+
+			table.assign(Hash::slots((u32) paths.size()), SBPath{});
+
+			u32 mask = (u32) table.size() - 1;
+
+			for (const SBPath &path : paths) {
+
+				u32 i = path.hash & mask, probes = 0;
+
+				for (; probes < (u32) table.size() && (table[i].flags & (u8) SBPathFlag::USED) != 0; i = (i + 1) & mask, ++probes)
+					if (table[i].hash == path.hash)
+						return Log::error("oiSB::makePaths; hash collision between paths");
+
+				if (probes == (u32) table.size())
+					return Log::error("oiSB::makePaths; the table is full");
+
+				table[i] = path;
+				table[i].flags |= (u8) SBPathFlag::USED;
+			}
+
+			return true;
+		}
+
+		inline const SBPath *oiSB::probePath(const std::vector<SBPath> &table, u32 hash) {
+
+			u32 mask = (u32) table.size() - 1;
+
+			//Bounded by the number of slots; so it can't get stuck on a full table
+			for (u32 i = hash & mask, probes = 0; probes < (u32) table.size() && (table[i].flags & (u8) SBPathFlag::USED) != 0; i = (i + 1) & mask, ++probes)
+				if (table[i].hash == hash)
+					return table.data() + i;
+
+			return nullptr;
+		}
+
+		inline bool oiSB::checkPaths(const std::vector<SBPath> &table, u32 size) {
+
+			u32 slots = (u32) table.size();
+
+			if (slots == 0)
+				return true;
+
+			if ((slots & (slots - 1)) != 0)
+				return Log::error("oiSB::checkPaths; the slot count isn't a power of two");
+
+			//The elements of a runtime array (and their members) start at the end of the buffer
+			u64 limit = size;
+			bool empty = false;
+
+			for (const SBPath &path : table)
+				if ((path.flags & (u8) SBPathFlag::USED) == 0)
+					empty = true;
+				else if (path.arraySize == 0) {
+
+					if (path.offset > size)
+						return Log::error("oiSB::checkPaths; runtime array outside of the buffer");
+
+					u64 end = (u64) path.offset + (path.stride > path.length ? path.stride : path.length);
+
+					if (end > limit)
+						limit = end;
+				}
+
+			if (!empty)
+				return Log::error("oiSB::checkPaths; the table has no empty slot");
+
+			for (const SBPath &path : table) {
+
+				if ((path.flags & (u8) SBPathFlag::USED) == 0)
+					continue;
+
+				u64 end = (u64) path.offset + path.length;
+
+				if (path.arraySize > 1)
+					end += (u64)(path.arraySize - 1) * path.stride;
+
+				if (path.length == 0 || end > limit)
+					return Log::error("oiSB::checkPaths; path outside of the buffer");
+			}
+
+			return true;
+		}
+
+		inline const SBPath *oiSB::findPath(const std::vector<SBPath> &table, std::string_view path, u32 &offset) {
+
+			offset = 0;
+
+			if (table.empty())
+				return nullptr;
+
+			u32 hash = Hash::offsetBasis;
+			bool first = true, indexed = false;
+
+			for (size_t i = 0, j; i <= path.size(); i = j + 1) {
+
+				j = path.find('/', i);
+
+				if (j == std::string_view::npos)
+					j = path.size();
+
+				std::string_view seg = path.substr(i, j - i);
+
+				if (seg.empty())
+					return nullptr;
+
+				u32 index = 0;
+				bool isIndex = seg.size() <= 9;
+
+				for (char c : seg)
+					if (c >= '0' && c <= '9') index = index * 10 + (u32)(c - '0');
+					else {
+						isIndex = false;
+						break;
+					}
+
+				if (!isIndex) {
+
+					if (!first)
+						hash = Hash::fnv1a("/", 1, hash);
+
+					hash = Hash::fnv1a(seg.data(), seg.size(), hash);
+					first = indexed = false;
+					continue;
+				}
+
+				//The stride is of one flattened element; so every array takes a single index
+				if (first || indexed)
+					return nullptr;
+
+				indexed = true;
+
+				const SBPath *arr = probePath(table, hash);
+
+				if (arr == nullptr || (arr->arraySize != 0 && index >= arr->arraySize))
+					return nullptr;
+
+				offset += index * arr->stride;
+			}
+
+			const SBPath *res = probePath(table, hash);
+
+			if (res != nullptr)
+				offset += res->offset;
+
+			return res;
+		}
+
 	}
 }
\ No newline at end of file
@@ -116,7 +116,8 @@ namespace oi {
 
 			u32 size;
 
-			SHFile(std::vector<SHStage> stage, std::vector<SHInputVar> ivar, std::vector<SHRegister> registers, std::vector<SHOutput> outputs, SLFile stringlist, std::vector<SBFile> buffers, std::vector<u8> bytecode) : stage(stage), ivar(ivar), registers(registers), outputs(outputs), stringlist(stringlist), buffers(buffers), bytecode(bytecode) {}
+			SHFile(std::vector<SHStage> stage, std::vector<SHInputVar> ivar, std::vector<SHRegister> registers, std::vector<SHOutput> outputs, SLFile stringlist, std::vector<SBFile> buffers, std::vector<u8> bytecode) : 
+				stage(std::move(stage)), ivar(std::move(ivar)), registers(std::move(registers)), outputs(std::move(outputs)), stringlist(std::move(stringlist)), buffers(std::move(buffers)), bytecode(std::move(bytecode)) {}
 			SHFile() : SHFile({}, {}, {}, {}, {}, {}, {}) {}
 
 		};
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "oish.h"
+
+namespace oi {
+
+	namespace gc {
+
+		//oiSX; the reflection of a shader that the oiSH (v0_0_1) format can't store
+		//oish_gen writes it next to the oiSH file (<path>.oiSX); names are indices into the oiSH string list
+
+		DEnum(SXHeaderVersion, u8,
+			Undefined = 0, v0_1 = 1
+		);
+
+		struct SXHeader {
+
+			char header[4] = { 'o', 'i', 'S', 'X' };
+
+			u8 version = SXHeaderVersion::v0_1;		//SXHeaderVersion_s
+			u8 buffers = 0;							//SHHeader::buffers
+			u8 pushConstants = 0;					//SHRegisterAccess of the push constants; 0 if there are none
+			u8 stored = 0;							//Stages in the stage store; 0 or every stage
+
+			u16 specConstants = 0;
+			u16 padding = 0;
+
+		};
+
+		//Path table and active ranges of a buffer
+		struct SXBuffer {
+
+			u32 size = 0;								//Declared size of the buffer; runtime arrays count as 0 elements
+			std::vector<SBPath> paths;					//Hash table (oiSB::makePaths)
+			std::vector<SBActiveRange> activeRanges;	//Coalesced per stage
+
+		};
+
+		struct SXSpecConstant {
+
+			u32 id;				//constant_id
+			u16 nameIndex;
+			u8 type;			//TextureFormat
+			u8 padding;
+
+			u64 value;			//Default value; the raw bits of the scalar
+
+			SXSpecConstant(u32 id, u16 nameIndex, u8 type, u64 value) : id(id), nameIndex(nameIndex), type(type), padding(0), value(value) {}
+			SXSpecConstant() : SXSpecConstant(0, 0, 0, 0) {}
+
+		};
+
+		//The contents of an SX file
+		struct SXFile {
+
+			SXHeader header;
+			std::vector<SXBuffer> buffers;				//In SHFile::buffers order
+			SBFile pushConstants;						//If header.pushConstants != 0
+			SXBuffer pushConstantPaths;					//If header.pushConstants != 0
+			std::vector<SXSpecConstant> specConstants;
+			std::vector<Hash256> codeHashes;			//Stage store (ShaderStageStore) keys of every stage (in stage order); empty if it wasn't stored
+
+		};
+
+		//Layout: SXHeader, SXBuffer[buffers], if pushConstants; oiSB and SXBuffer, SXSpecConstant[specConstants], Hash256[stored]
+		//SXBuffer is stored as u32 size, u32 slots, SBPath[slots], u32 ranges, SBActiveRange[ranges]
+		//The oiSB is stored as SBHeader, SBStruct[structs], SBVar[vars]
+		struct oiSX {
+
+			static bool read(Buffer data, SXFile &file);
+
+			static u32 getSize(const SXFile &file);
+			static u32 write(const SXFile &file, Buffer target);		//Writes into target; returns size or 0 if it doesn't fit
+
+		private:
+
+			template<typename T>
+			static void put(u8 *&ptr, const std::vector<T> &vec) {
+
+				if (vec.empty())
+					return;
+
+				memcpy(ptr, vec.data(), vec.size() * sizeof(T));
+				ptr += vec.size() * sizeof(T);
+			}
+
+			template<typename T>
+			static bool get(const u8 *&ptr, const u8 *end, std::vector<T> &vec, u32 count) {
+
+				if ((u64)(end - ptr) < (u64) count * sizeof(T))
+					return false;
+
+				vec.resize(count);
+
+				if (count != 0)
+					memcpy(vec.data(), ptr, (size_t) count * sizeof(T));
+
+				ptr += (size_t) count * sizeof(T);
+				return true;
+			}
+
+			static bool get(const u8 *&ptr, const u8 *end, u32 &count);
+
+			static u32 getSize(const SXBuffer &buffer);
+			static void put(u8 *&ptr, const SXBuffer &buffer);
+			static bool get(const u8 *&ptr, const u8 *end, SXBuffer &buffer);
+
+		};
+
+		inline u32 oiSX::getSize(const SXBuffer &buffer) {
+			return (u32)(sizeof(u32) * 3 + buffer.paths.size() * sizeof(SBPath) + buffer.activeRanges.size() * sizeof(SBActiveRange));
+		}
+
+		inline u32 oiSX::getSize(const SXFile &file) {
+
+			u32 size = (u32) sizeof(SXHeader);
+
+			for (const SXBuffer &buffer : file.buffers)
+				size += getSize(buffer);
+
+			if (file.header.pushConstants != 0)
+				size += oiSB::getSize(file.pushConstants) + getSize(file.pushConstantPaths);
+
+			return size + (u32)(file.specConstants.size() * sizeof(SXSpecConstant) + file.codeHashes.size() * sizeof(Hash256));
+		}
+
+		inline void oiSX::put(u8 *&ptr, const SXBuffer &buffer) {
+
+			u32 slots = (u32) buffer.paths.size(), ranges = (u32) buffer.activeRanges.size();
+
+			memcpy(ptr, &buffer.size, sizeof(buffer.size));
+			ptr += sizeof(buffer.size);
+
+			memcpy(ptr, &slots, sizeof(slots));
+			ptr += sizeof(slots);
+			put(ptr, buffer.paths);
+
+			memcpy(ptr, &ranges, sizeof(ranges));
+			ptr += sizeof(ranges);
+			put(ptr, buffer.activeRanges);
+		}
+
+		inline u32 oiSX::write(const SXFile &file, Buffer target) {
+
+			u32 size = getSize(file);
+
+			if (target.size() < size)
+				return Log::error("oiSX::write; target buffer is too small");
+
+			if (file.buffers.size() > u8_MAX || file.codeHashes.size() > u8_MAX || file.specConstants.size() > u16_MAX)
+				return Log::error("oiSX::write; too many elements for the SXHeader");
+
+			SXHeader header = file.header;
+			memcpy(header.header, "oiSX", 4);
+			header.version = SXHeaderVersion::v0_1;
+			header.buffers = (u8) file.buffers.size();
+			header.stored = (u8) file.codeHashes.size();
+			header.specConstants = (u16) file.specConstants.size();
+
+			u8 *ptr = target.addr(), *end = ptr + size;
+
+			memcpy(ptr, &header, sizeof(header));
+			ptr += sizeof(header);
+
+			for (const SXBuffer &buffer : file.buffers)
+				put(ptr, buffer);
+
+			if (header.pushConstants != 0) {
+
+				u32 written = oiSB::write(file.pushConstants, Buffer::construct(ptr, (u32)(end - ptr)));
+
+				if (written == 0)
+					return 0;
+
+				ptr += written;
+				put(ptr, file.pushConstantPaths);
+			}
+
+			put(ptr, file.specConstants);
+			put(ptr, file.codeHashes);
+
+			return size;
+		}
+
+		inline bool oiSX::get(const u8 *&ptr, const u8 *end, u32 &count) {
+
+			if ((size_t)(end - ptr) < sizeof(count))
+				return false;
+
+			memcpy(&count, ptr, sizeof(count));
+			ptr += sizeof(count);
+			return true;
+		}
+
+		inline bool oiSX::get(const u8 *&ptr, const u8 *end, SXBuffer &buffer) {
+
+			u32 slots, ranges;
+
+			if (!get(ptr, end, buffer.size) || !get(ptr, end, slots) || !get(ptr, end, buffer.paths, slots) || !get(ptr, end, ranges) || !get(ptr, end, buffer.activeRanges, ranges))
+				return false;
+
+			return oiSB::checkPaths(buffer.paths, buffer.size);
+		}
+
+		inline bool oiSX::read(Buffer data, SXFile &file) {
+
+			const u8 *ptr = data.addr(), *end = ptr + data.size();
+
+			if (data.size() < (u32) sizeof(SXHeader))
+				return Log::error("oiSX::read; file is too small");
+
+			memcpy(&file.header, ptr, sizeof(SXHeader));
+			ptr += sizeof(SXHeader);
+
+			if (memcmp(file.header.header, "oiSX", 4) != 0 || file.header.version != SXHeaderVersion::v0_1)
+				return Log::error("oiSX::read; invalid header or version");
+
+			file.buffers.resize(file.header.buffers);
+
+			for (SXBuffer &buffer : file.buffers)
+				if (!get(ptr, end, buffer))
+					return Log::error("oiSX::read; invalid buffer reflection");
+
+			if (file.header.pushConstants != 0) {
+
+				SBHeader &sbheader = file.pushConstants.header;
+
+				if ((size_t)(end - ptr) < sizeof(SBHeader))
+					return Log::error("oiSX::read; invalid push constants");
+
+				memcpy(&sbheader, ptr, sizeof(SBHeader));
+				ptr += sizeof(SBHeader);
+
+				if (!get(ptr, end, file.pushConstants.structs, sbheader.structs) || !get(ptr, end, file.pushConstants.vars, sbheader.vars) || !get(ptr, end, file.pushConstantPaths))
+					return Log::error("oiSX::read; invalid push constants");
+
+				file.pushConstants.size = oiSB::getSize(file.pushConstants);
+			}
+
+			if (!get(ptr, end, file.specConstants, file.header.specConstants) || !get(ptr, end, file.codeHashes, file.header.stored))
+				return Log::error("oiSX::read; file is too small");
+
+			return true;
+		}
+
+	}
+
+}
\ No newline at end of file
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <types/buffer.h>
+#include <utils/log.h>
+#include <cstring>
+
+namespace oi {
+
+	namespace gc {
+
+		//Compact SPIR-V (smol-v style re-encoding of optimized SPIR-V)
+		//Every instruction is stored as varints:
+		//(opcode << 2) | SPVCompactLayout, the operand count, the result type, the result id and the other operands.
+		//The result id is stored as zigzag delta relative to the previous result id, so it is almost always 1 byte.
+		//Decoding is a single streaming pass and results in the exact same SPIR-V words.
+
+		enum class SPVCompactLayout : u8 {
+			NONE = 0,
+			RESULT = 1,				//Instruction has a result id
+			RESULT_TYPE = 2			//Instruction has a result type (always followed by a result id)
+		};
+
+		struct SPVCompactHeader {
+
+			char header[4];			//oiSC
+
+			u32 words;				//SPIR-V words; including the SPIR-V header
+			u32 spirv[5];			//SPIR-V header (magic, version, generator, bound, schema)
+
+		};
+
+		struct SPVCompact {
+
+			typedef SPVCompactLayout (*LayoutFunc)(u16 op);
+
+			static bool isCompact(Buffer data);
+
+			static UniqueBuffer encode(const u32 *spirv, u32 words, LayoutFunc layout);
+			static bool decode(Buffer data, std::vector<u32> &spirv);
+
+		private:
+
+			static void putVarint(std::vector<u8> &out, u32 val);
+			static bool getVarint(const u8 *&ptr, const u8 *end, u32 &val);
+
+			static u32 zigzag(i32 val) { return ((u32) val << 1) ^ (u32)(val >> 31); }
+			static i32 unzigzag(u32 val) { return (i32)(val >> 1) ^ -(i32)(val & 1); }
+
+		};
+
+		inline bool SPVCompact::isCompact(Buffer data) {
+			return data.size() >= (u32) sizeof(SPVCompactHeader) && memcmp(data.addr(), "oiSC", 4) == 0;
+		}
+
+		inline void SPVCompact::putVarint(std::vector<u8> &out, u32 val) {
+
+			while (val >= 0x80U) {
+				out.push_back((u8)(val | 0x80U));
+				val >>= 7;
+			}
+
+			out.push_back((u8) val);
+		}
+
+		inline bool SPVCompact::getVarint(const u8 *&ptr, const u8 *end, u32 &val) {
+
+			val = 0;
+
+			for (u32 shift = 0; shift < 35; shift += 7) {
+
+				if (ptr >= end) return false;
+
+				u8 b = *ptr;
+				++ptr;
+
+				//The fifth byte only has 4 bits left
+				if (shift == 28 && b > 0x0FU) return false;
+
+				val |= (u32)(b & 0x7FU) << shift;
+
+				if ((b & 0x80U) == 0) return true;
+			}
+
+			return false;
+		}
+
+		inline UniqueBuffer SPVCompact::encode(const u32 *spirv, u32 words, LayoutFunc layout) {
+
+			if (words < 5) {
+				Log::error("SPVCompact::encode; SPIR-V is missing its header");
+				return {};
+			}
+
+			SPVCompactHeader header;
+			memcpy(header.header, "oiSC", 4);
+			header.words = words;
+			memcpy(header.spirv, spirv, sizeof(header.spirv));
+
+			std::vector<u8> out(sizeof(header));
+			out.reserve(words * 2U);
+			memcpy(out.data(), &header, sizeof(header));
+
+			u32 prevResult = 0;
+
+			for (u32 i = 5; i < words; ) {
+
+				u16 op = (u16)(spirv[i] & 0xFFFFU);
+				u32 count = spirv[i] >> 16;
+
+				if (count == 0 || i + count > words) {
+					Log::error("SPVCompact::encode; invalid instruction");
+					return {};
+				}
+
+				u32 operands = count - 1;
+				const u32 *operand = spirv + i + 1;
+
+				u8 flags = (u8) layout(op);
+
+				if ((flags & (u8) SPVCompactLayout::RESULT_TYPE) != 0 && operands < 2)
+					flags = 0;
+				else if ((flags & (u8) SPVCompactLayout::RESULT) != 0 && operands < 1)
+					flags = 0;
+
+				putVarint(out, ((u32) op << 2) | flags);
+				putVarint(out, operands);
+
+				u32 j = 0;
+
+				if ((flags & (u8) SPVCompactLayout::RESULT_TYPE) != 0)
+					putVarint(out, operand[j++]);
+
+				if (flags != 0) {
+					putVarint(out, zigzag((i32)(operand[j] - prevResult)));
+					prevResult = operand[j++];
+				}
+
+				for (; j < operands; ++j)
+					putVarint(out, operand[j]);
+
+				i += count;
+			}
+
+			return UniqueBuffer(out.data(), out.size());
+		}
+
+		inline bool SPVCompact::decode(Buffer data, std::vector<u32> &spirv) {
+
+			if (!isCompact(data))
+				return Log::error("SPVCompact::decode; data isn't compact SPIR-V");
+
+			SPVCompactHeader header;
+			memcpy(&header, data.addr(), sizeof(header));
+
+			if (header.words < 5)
+				return Log::error("SPVCompact::decode; invalid header");
+
+			spirv.resize(header.words);
+			memcpy(spirv.data(), header.spirv, sizeof(header.spirv));
+
+			const u8 *ptr = data.addr() + sizeof(header), *end = data.addr() + data.size();
+			u32 *out = spirv.data() + 5, *outEnd = spirv.data() + spirv.size();
+
+			u32 prevResult = 0, opFlags, operands;
+
+			while (out < outEnd) {
+
+				if (!getVarint(ptr, end, opFlags) || !getVarint(ptr, end, operands) || operands >= 0xFFFFU || out + operands + 1 > outEnd)
+					return Log::error("SPVCompact::decode; invalid instruction");
+
+				u32 flags = opFlags & 0x3U;
+
+				//The result type and id are operands too; reject layouts that don't fit in them (like encode)
+				if ((flags & (u8) SPVCompactLayout::RESULT_TYPE) != 0 ? operands < 2 : flags != 0 && operands < 1)
+					return Log::error("SPVCompact::decode; invalid instruction layout");
+
+				*out = ((operands + 1) << 16) | ((opFlags >> 2) & 0xFFFFU);
+				++out;
+
+				u32 j = 0, val;
+
+				if ((flags & (u8) SPVCompactLayout::RESULT_TYPE) != 0) {
+
+					if (!getVarint(ptr, end, val)) return Log::error("SPVCompact::decode; invalid result type");
+
+					*out = val;
+					++out;
+					++j;
+				}
+
+				if (flags != 0) {
+
+					if (!getVarint(ptr, end, val)) return Log::error("SPVCompact::decode; invalid result");
+
+					*out = prevResult = prevResult + (u32) unzigzag(val);
+					++out;
+					++j;
+				}
+
+				for (; j < operands; ++j) {
+
+					if (!getVarint(ptr, end, val)) return Log::error("SPVCompact::decode; invalid operand");
+
+					*out = val;
+					++out;
+				}
+
+			}
+
+			if (ptr != end)
+				return Log::error("SPVCompact::decode; trailing data");
+
+			return true;
+		}
+
+	}
+
+}
\ No newline at end of file
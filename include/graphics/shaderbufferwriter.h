@@ -0,0 +1,284 @@
+#pragma once
+
+#include "shaderbuffer.h"
+#include "graphics.h"
+#include "dirtyranges.h"
+#include "format/oisb.h"
+#include <types/simd.h>
+#include <string_view>
+#include <cstring>
+
+namespace oi {
+
+	namespace gc {
+
+		//A path that is resolved once (ShaderBufferWriter::getHandle); accessing it is a bounds check and a pointer add (and a type check in debug builds)
+		struct ShaderBufferHandle {
+
+			u32 offset = 0;			//From the start of the buffer
+			u32 length = 0;			//Size of one element
+			u32 stride = 0;			//Bytes between array elements
+			u32 arraySize = 0;		//0 if it's unbounded (runtime array)
+
+			u8 type = 0;			//TextureFormat
+			u8 flags = 0;			//SBPathFlag
+
+			bool isValid() const { return length != 0; }
+
+			//Element i of an array
+			ShaderBufferHandle operator[](u32 i) const {
+
+				if (arraySize != 0 && i >= arraySize)
+					Log::throwError<ShaderBufferHandle, 0x0>("ShaderBufferHandle; array index out of bounds");
+
+				ShaderBufferHandle res = *this;
+				res.offset += i * stride;
+				res.arraySize = 1;
+				return res;
+			}
+
+		};
+
+		//CPU copy of the data of a ShaderBuffer that is addressed through its path table (oiSB::makePaths; reflected by oish_gen)
+		//Paths are found with one hash probe, handles skip even that and arrays are copied at once or repacked to their stride
+		//Writes are tracked; so flush only uploads the modified ranges (if the GBuffer is persistent)
+		//GBuffer::set and GBuffer::copy always write from the start of the buffer (they have no offset), so a GBuffer that isn't persistent is uploaded whole
+		//It replaces open/set/close of the ShaderBuffer; the ShaderBuffer's own CPU copy isn't used
+		class ShaderBufferWriter {
+
+		public:
+
+			ShaderBufferWriter(Graphics *g, ShaderBuffer *buffer, std::vector<SBPath> paths);
+			~ShaderBufferWriter() { current.deconstruct(); }
+
+			ShaderBufferWriter(const ShaderBufferWriter&) = delete;
+			ShaderBufferWriter &operator=(const ShaderBufferWriter&) = delete;
+
+			//Writes through the returned reference aren't tracked; use set or markDirty
+			template<typename T>
+			T &get(String path);
+
+			template<typename T>
+			void set(String path, T t);
+
+			//Copies count elements into the array at path ("lights"), starting at array element first
+			//The layout is validated once; if T matches the array stride it's a single copy, otherwise the elements are repacked to the stride (StridedOps)
+			//Runtime arrays are bound by the size of the buffer
+			template<typename T>
+			void setArray(String path, const T *data, u32 count, u32 first = 0U);
+
+			//Resolves a path ("lights/3/color") once; returns an invalid handle if it doesn't exist
+			ShaderBufferHandle getHandle(std::string_view path) const;
+
+			template<typename T>
+			T &get(const ShaderBufferHandle &handle);
+
+			template<typename T>
+			void set(const ShaderBufferHandle &handle, T t);
+
+			void markDirty(u32 offset, u32 length) { dirty.add(offset, length); }
+			const std::vector<DirtyRange> &getDirty() { return dirty.get(); }
+
+			ShaderBuffer *getBuffer() { return buffer; }
+			Buffer getData() { return current; }
+
+			//Uploads the modified ranges into the GBuffer; only those are copied if it's persistent (mapped), otherwise the whole buffer is set
+			//The copied ranges are flushed; so it also works if the mapped memory isn't host coherent
+			bool flush();
+
+		private:
+
+			const SBPath *find(String path, u32 &offset) const { return oiSB::findPath(paths, std::string_view(path.toCString(), path.size()), offset); }
+
+			bool flushMapped(GBuffer *gbuffer);
+
+			Graphics *g;
+			ShaderBuffer *buffer;
+			std::vector<SBPath> paths;
+			Buffer current;
+			DirtyRanges dirty;
+			u64 atom = 0;			//nonCoherentAtomSize; queried on the first flush
+
+		};
+
+		inline ShaderBufferWriter::ShaderBufferWriter(Graphics *g, ShaderBuffer *buffer, std::vector<SBPath> paths) : g(g), buffer(buffer), paths(std::move(paths)), current(buffer->getSize()) {
+			memset(current.addr(), 0, current.size());
+		}
+
+		template<typename T>
+		T &ShaderBufferWriter::get(String path) {
+
+			u32 offset;
+			const SBPath *p = find(path, offset);
+
+			if (p == nullptr)
+				Log::throwError<ShaderBufferWriter, 0x0>(String("ShaderBufferWriter::get; couldn't find ") + path);
+
+			if (!ShaderBufferCast<T>::check(p->length, TextureFormat(p->type)) || offset + (u32) sizeof(T) > current.size())
+				Log::throwError<ShaderBufferWriter, 0x1>(String("Couldn't cast ShaderBuffer path with format ") + TextureFormat(p->type).getName() + " (" + path + ")");
+
+			return *(T*)(current.addr() + offset);
+		}
+
+		template<typename T>
+		void ShaderBufferWriter::set(String path, T t) {
+
+			T &dst = get<T>(path);
+			dst = t;
+
+			markDirty((u32)((u8*) &dst - current.addr()), (u32) sizeof(T));
+		}
+
+		inline ShaderBufferHandle ShaderBufferWriter::getHandle(std::string_view path) const {
+
+			u32 offset;
+			const SBPath *p = oiSB::findPath(paths, path, offset);
+
+			if (p == nullptr)
+				return {};
+
+			ShaderBufferHandle handle;
+			handle.offset = offset;
+			handle.length = p->length;
+			handle.stride = p->stride;
+			handle.arraySize = p->arraySize;
+			handle.type = p->type;
+			handle.flags = p->flags;
+			return handle;
+		}
+
+		template<typename T>
+		T &ShaderBufferWriter::get(const ShaderBufferHandle &handle) {
+
+			//Handles can come from another writer or a stale layout; so the bounds are always checked
+			if ((u64) handle.offset + sizeof(T) > current.size())
+				Log::throwError<ShaderBufferWriter, 0x5>("ShaderBufferWriter::get; handle is out of bounds");
+
+		#ifdef _DEBUG
+
+			if (!handle.isValid() || !ShaderBufferCast<T>::check(handle.length, TextureFormat(handle.type)))
+				Log::throwError<ShaderBufferWriter, 0x4>("ShaderBufferWriter::get; handle doesn't match the type");
+
+		#endif
+
+			return *(T*)(current.addr() + handle.offset);
+		}
+
+		template<typename T>
+		void ShaderBufferWriter::set(const ShaderBufferHandle &handle, T t) {
+			get<T>(handle) = t;
+			markDirty(handle.offset, (u32) sizeof(T));
+		}
+
+		template<typename T>
+		void ShaderBufferWriter::setArray(String path, const T *data, u32 count, u32 first) {
+
+			//TVec and TMatrix have user defined copies, but they are plain data
+			static_assert(std::is_standard_layout<T>::value && std::is_trivially_destructible<T>::value, "ShaderBufferWriter::setArray requires plain data");
+
+			u32 offset;
+			const SBPath *p = find(path, offset);
+
+			if (p == nullptr)
+				Log::throwError<ShaderBufferWriter, 0x0>(String("ShaderBufferWriter::setArray; couldn't find array (") + path + ")");
+
+			bool isStruct = (p->flags & (u8) SBPathFlag::IS_STRUCT) != 0;
+			u32 size = (u32) sizeof(T);
+
+			if ((isStruct ? size != p->length && size != p->stride : !ShaderBufferCast<T>::check(p->length, TextureFormat(p->type))) || size > p->stride)
+				Log::throwError<ShaderBufferWriter, 0x2>(String("ShaderBufferWriter::setArray; element type doesn't match the layout of ") + path);
+
+			if (count == 0)
+				return;
+
+			//Runtime arrays (arraySize 0) are only bound by the buffer
+			if ((p->arraySize != 0 && (u64) first + count > p->arraySize) || (u64) offset + ((u64) first + count - 1) * p->stride + p->length > current.size())
+				Log::throwError<ShaderBufferWriter, 0x3>(String("ShaderBufferWriter::setArray; out of bounds (") + path + ")");
+
+			u8 *dst = current.addr() + offset + (size_t) first * p->stride;
+			u32 copy = size < p->length ? size : p->length;
+
+			//The padding of the last element isn't copied; it can be outside of the buffer
+			if (size == p->stride)
+				memcpy(dst, data, (size_t)(count - 1) * size + copy);
+			else
+				StridedOps<T>::copy(dst, data, count, p->stride);
+
+			markDirty((u32)(dst - current.addr()), (count - 1) * p->stride + copy);
+		}
+
+		inline bool ShaderBufferWriter::flush() {
+
+			if (dirty.empty())
+				return true;
+
+			GBuffer *gbuffer = buffer->getBuffer();
+
+			if (gbuffer == nullptr)
+				return Log::error("ShaderBufferWriter::flush; the buffer doesn't have a GBuffer");
+
+			if (gbuffer->getInfo().persistent) {
+
+				u8 *dst = gbuffer->getAddress();
+
+				for (const DirtyRange &range : dirty.get())
+					memcpy(dst + range.start, current.addr() + range.start, range.size());
+
+				if (!flushMapped(gbuffer))
+					return Log::error("ShaderBufferWriter::flush; couldn't flush the mapped ranges");
+
+			} else if (!gbuffer->set(current))
+				return Log::error("ShaderBufferWriter::flush; couldn't upload the buffer");
+
+			dirty.clear();
+			return true;
+		}
+
+		inline bool ShaderBufferWriter::flushMapped(GBuffer *gbuffer) {
+
+		#ifdef __VULKAN__
+
+			if (atom == 0) {
+				VkPhysicalDeviceProperties properties;
+				vkGetPhysicalDeviceProperties(g->getExtension().pdevice, &properties);
+				atom = properties.limits.nonCoherentAtomSize;
+			}
+
+			u32 size = gbuffer->getSize();
+
+			std::vector<VkMappedMemoryRange> ranges;
+			ranges.reserve(dirty.get().size());
+
+			//Ranges have to be aligned to the atom size; the last one can extend to the end of the allocation
+
+			for (const DirtyRange &range : dirty.get()) {
+
+				VkDeviceSize start = range.start / atom * atom;
+				VkDeviceSize end = (range.end + atom - 1) / atom * atom;
+
+				VkMappedMemoryRange mapped{};
+				mapped.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+				mapped.memory = gbuffer->getExtension().memory;
+				mapped.offset = start;
+				mapped.size = end >= size ? VK_WHOLE_SIZE : end - start;
+
+				if (!ranges.empty() && ranges.back().size != VK_WHOLE_SIZE && ranges.back().offset + ranges.back().size >= start)
+					ranges.back().size = mapped.size == VK_WHOLE_SIZE ? VK_WHOLE_SIZE : end - ranges.back().offset;
+				else
+					ranges.push_back(mapped);
+			}
+
+			return vkFlushMappedMemoryRanges(g->getExtension().device, (u32) ranges.size(), ranges.data()) == VK_SUCCESS;
+
+		#else
+
+			(void) gbuffer;
+			return true;
+
+		#endif
+
+		}
+
+	}
+
+}
\ No newline at end of file
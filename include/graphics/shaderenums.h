@@ -33,6 +33,19 @@ namespace oi {
 
 		};
 
+		//Specialization constant; value is the default (raw bits of the scalar)
+		struct ShaderSpecConstant {
+
+			u32 id;
+			TextureFormat type;
+			String name;
+			u64 value;
+
+			ShaderSpecConstant(u32 id, TextureFormat type, String name, u64 value) : id(id), type(type), name(name), value(value) {}
+			ShaderSpecConstant() : ShaderSpecConstant(0U, TextureFormat::Undefined, "", 0U) {}
+
+		};
+
 		DEnum(ShaderRegisterType, u32,
 			Undefined = 0,
 			UBO = 1, SSBO = 2,
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <utils/hash.h>
+#include <file/filemanager.h>
+#include "graphics/graphics.h"
+#include "graphics/shaderstage.h"
+#include "graphics/format/spvcompact.h"
+
+namespace oi {
+
+	namespace gc {
+
+		//Content addressed ShaderStages; every unique bytecode (by SHA-256) is only created once
+		//Code is loaded from <path><hash>.ospv (written by oish_gen -store) and can be compact SPIR-V
+		//Every get increases the reference count of the stage, so Shaders can still destroy their stages as usual
+		//The store holds a reference to its stages too; so a stage can't be destroyed (and its address reused) while it has an entry
+		//Destroy the store before Graphics
+		class ShaderStageStore {
+
+		public:
+
+			ShaderStageStore(Graphics *g, String path = "res/shaders/store/") : g(g), path(path) {}
+			~ShaderStageStore() { clear(); }
+
+			ShaderStage *get(const Hash256 &hash, ShaderStageType type);			//Loads the code from the store if it wasn't created yet
+			ShaderStage *get(const Hash256 &hash, ShaderStageInfo info);			//Uses info if it wasn't created yet (info.code is copied)
+
+			void clear();			//Releases the references of the store; stages that are still used stay alive
+
+		private:
+
+			struct Entry {
+				ShaderStage *stage;
+				Buffer code;
+			};
+
+			ShaderStage *find(const Hash256 &hash);
+
+			Graphics *g;
+			String path;
+
+			std::unordered_map<Hash256, Entry> stages;
+
+		};
+
+		inline void ShaderStageStore::clear() {
+
+			for (auto &elem : stages) {
+				g->destroy(elem.second.stage);
+				elem.second.code.deconstruct();
+			}
+
+			stages.clear();
+		}
+
+		inline ShaderStage *ShaderStageStore::find(const Hash256 &hash) {
+
+			auto it = stages.find(hash);
+
+			if (it == stages.end())
+				return nullptr;
+
+			g->use(it->second.stage);
+			return it->second.stage;
+		}
+
+		inline ShaderStage *ShaderStageStore::get(const Hash256 &hash, ShaderStageInfo info) {
+
+			if (ShaderStage *stage = find(hash))
+				return stage;
+
+			Buffer code;
+
+			if (SPVCompact::isCompact(info.code)) {
+
+				std::vector<u32> spirv;
+
+				if (!SPVCompact::decode(info.code, spirv))
+					return (ShaderStage*) Log::throwError<ShaderStageStore, 0x0>(String("Couldn't decode stage ") + hash.toHex());
+
+				code = Buffer((u8*) spirv.data(), (u32)(spirv.size() * 4));
+
+			} else
+				code = Buffer(info.code.addr(), info.code.size());
+
+			ShaderStage *stage = g->create(hash.toHex(), ShaderStageInfo(code, info.type));
+
+			if (stage == nullptr) {
+				code.deconstruct();
+				return (ShaderStage*) Log::throwError<ShaderStageStore, 0x3>(String("Couldn't create stage ") + hash.toHex());
+			}
+
+			//The reference of the store; the caller owns the one from create
+			g->use(stage);
+			stages[hash] = { stage, code };
+
+			return stage;
+		}
+
+		inline ShaderStage *ShaderStageStore::get(const Hash256 &hash, ShaderStageType type) {
+
+			if (ShaderStage *stage = find(hash))
+				return stage;
+
+			Buffer code;
+
+			if (!wc::FileManager::get()->read(path + hash.toHex() + ".ospv", code))
+				return (ShaderStage*) Log::throwError<ShaderStageStore, 0x1>(String("Couldn't load stage ") + hash.toHex() + " from the store");
+
+			if (Hash::sha256(code.addr(), code.size()) != hash) {
+				code.deconstruct();
+				return (ShaderStage*) Log::throwError<ShaderStageStore, 0x2>(String("Stage ") + hash.toHex() + " in the store is corrupted");
+			}
+
+			ShaderStage *stage = get(hash, ShaderStageInfo(code, type));
+			code.deconstruct();
+
+			return stage;
+		}
+
+	}
+
+}
\ No newline at end of file
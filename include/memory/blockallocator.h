@@ -2,6 +2,15 @@
 
 #include "types/generic.h"
 #include "types/buffer.h"
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <type_traits>
+
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
 
 namespace oi {
 
@@ -69,4 +78,791 @@ namespace oi {
 
 	};
 
+	//Virtual block allocator with O(1) alloc and dealloc; a drop-in for VirtualBlockAllocator, which scans its ranges linearly
+	//Two level segregated fit (TLSF): free ranges are binned by size class (power of two, split into 16 linear steps)
+	//A bitmap per level finds a fitting bin in O(1); freed ranges are merged with their physical neighbours in O(1)
+	class TLSFAllocator {
+
+	public:
+
+		TLSFAllocator(u32 length);
+
+		//Returns a zero sized allocation if it doesn't fit; alignment has to be a power of two
+		BlockAllocation alloc(u32 length, u32 alignment = 1);
+		bool dealloc(u32 pos);
+
+		u32 size();
+
+		u32 getFree() const { return freeSize; }
+		u32 getAllocations() const { return (u32) allocations.size(); }
+		u32 getFreeRanges() const { return freeRanges; }
+
+		//Largest range that can still be allocated
+		u32 getLargestFree() const;
+
+		//1 - largest free range / free size; 0 means all free space is in one range
+		f32 getFragmentation() const { return freeSize == 0 ? 0.f : 1.f - (f32) getLargestFree() / freeSize; }
+
+	protected:
+
+		static constexpr u32 slBits = 4, slCount = 1U << slBits, flCount = 32 - slBits + 1, null = u32_MAX;
+
+		struct Range {
+			u32 start, size;
+			u32 prevPhys, nextPhys;			//Neighbouring ranges in memory
+			u32 prevFree, nextFree;			//Ranges in the same bin
+			bool isFree;
+		};
+
+		static void mapping(u32 size, u32 &fl, u32 &sl);
+		static u32 bitScan(u32 mask);			//Index of the lowest set bit
+		static u32 bitScanReverse(u32 mask);	//Index of the highest set bit
+
+		u32 findFree(u32 size) const;
+
+		void insertFree(u32 range);
+		void removeFree(u32 range);
+
+		//Cuts the range after size; returns the remainder (which isn't in a bin yet)
+		u32 split(u32 range, u32 size);
+
+		u32 newRange(u32 start, u32 size);
+		void deleteRange(u32 range);
+
+		std::vector<Range> ranges;
+		std::vector<u32> unusedRanges;
+		std::unordered_map<u32, u32> allocations;			//start -> range
+
+		u32 flBitmap = 0, slBitmap[flCount] = {};
+		u32 bins[flCount][slCount];
+
+		u32 freeSize = 0, freeRanges = 0;
+
+	private:
+
+		u32 length;
+
+	};
+
+	inline TLSFAllocator::TLSFAllocator(u32 length) : length(length) {
+
+		for (auto &fl : bins)
+			for (u32 &sl : fl)
+				sl = null;
+
+		if (length != 0)
+			insertFree(newRange(0, length));
+	}
+
+	inline u32 TLSFAllocator::size() { return length; }
+
+	inline u32 TLSFAllocator::bitScan(u32 mask) {
+		#ifdef _MSC_VER
+			unsigned long i;
+			_BitScanForward(&i, mask);
+			return (u32) i;
+		#else
+			return (u32) __builtin_ctz(mask);
+		#endif
+	}
+
+	inline u32 TLSFAllocator::bitScanReverse(u32 mask) {
+		#ifdef _MSC_VER
+			unsigned long i;
+			_BitScanReverse(&i, mask);
+			return (u32) i;
+		#else
+			return 31 - (u32) __builtin_clz(mask);
+		#endif
+	}
+
+	inline void TLSFAllocator::mapping(u32 size, u32 &fl, u32 &sl) {
+
+		if (size < slCount) {
+			fl = 0;
+			sl = size;
+			return;
+		}
+
+		u32 log2 = bitScanReverse(size);
+		sl = (size >> (log2 - slBits)) ^ slCount;
+		fl = log2 - slBits + 1;
+	}
+
+	inline u32 TLSFAllocator::newRange(u32 start, u32 size) {
+
+		Range r = { start, size, null, null, null, null, false };
+
+		if (unusedRanges.empty()) {
+			ranges.push_back(r);
+			return (u32) ranges.size() - 1;
+		}
+
+		u32 i = unusedRanges.back();
+		unusedRanges.pop_back();
+		ranges[i] = r;
+		return i;
+	}
+
+	inline void TLSFAllocator::deleteRange(u32 range) {
+		unusedRanges.push_back(range);
+	}
+
+	inline void TLSFAllocator::insertFree(u32 range) {
+
+		Range &r = ranges[range];
+
+		u32 fl, sl;
+		mapping(r.size, fl, sl);
+
+		r.isFree = true;
+		r.prevFree = null;
+		r.nextFree = bins[fl][sl];
+
+		if (r.nextFree != null)
+			ranges[r.nextFree].prevFree = range;
+
+		bins[fl][sl] = range;
+		flBitmap |= 1U << fl;
+		slBitmap[fl] |= 1U << sl;
+
+		freeSize += r.size;
+		++freeRanges;
+	}
+
+	inline void TLSFAllocator::removeFree(u32 range) {
+
+		Range &r = ranges[range];
+
+		u32 fl, sl;
+		mapping(r.size, fl, sl);
+
+		if (r.prevFree != null)
+			ranges[r.prevFree].nextFree = r.nextFree;
+		else {
+
+			bins[fl][sl] = r.nextFree;
+
+			if (r.nextFree == null) {
+
+				slBitmap[fl] &= ~(1U << sl);
+
+				if (slBitmap[fl] == 0)
+					flBitmap &= ~(1U << fl);
+			}
+		}
+
+		if (r.nextFree != null)
+			ranges[r.nextFree].prevFree = r.prevFree;
+
+		r.isFree = false;
+
+		freeSize -= r.size;
+		--freeRanges;
+	}
+
+	inline u32 TLSFAllocator::split(u32 range, u32 size) {
+
+		u32 rest = newRange(ranges[range].start + size, ranges[range].size - size);
+		Range &r = ranges[range];
+
+		ranges[rest].prevPhys = range;
+		ranges[rest].nextPhys = r.nextPhys;
+
+		if (r.nextPhys != null)
+			ranges[r.nextPhys].prevPhys = rest;
+
+		r.nextPhys = rest;
+		r.size = size;
+
+		return rest;
+	}
+
+	inline BlockAllocation TLSFAllocator::alloc(u32 size, u32 alignment) {
+
+		//Worst case padding is included, so any range that is found can be aligned
+		u64 padded = (u64) size + (alignment <= 1 ? 0 : alignment - 1);
+
+		if (size == 0 || padded > freeSize)
+			return { 0, 0 };
+
+		u32 range = findFree((u32) padded);
+
+		if (range == null)
+			return { 0, 0 };
+
+		removeFree(range);
+
+		//Give the padding in front back
+		u32 padding = alignment <= 1 ? 0 : (alignment - ranges[range].start % alignment) % alignment;
+
+		if (padding != 0) {
+			u32 aligned = split(range, padding);
+			insertFree(range);
+			range = aligned;
+		}
+
+		//Split off the remainder
+		if (ranges[range].size > size)
+			insertFree(split(range, size));
+
+		allocations[ranges[range].start] = range;
+		return { ranges[range].start, size };
+	}
+
+	inline u32 TLSFAllocator::findFree(u32 size) const {
+
+		//Round up to the next bin; so any range in the bin that is found fits
+		u32 fl, sl;
+		u64 rounded = size < slCount ? size : (u64) size + (1ULL << (bitScanReverse(size) - slBits)) - 1;
+
+		if (rounded <= u32_MAX) {
+
+			mapping((u32) rounded, fl, sl);
+
+			u32 slMap = fl < flCount ? slBitmap[fl] & (u32_MAX << sl) : 0;
+
+			if (slMap == 0 && fl + 1 < flCount && (flBitmap >> (fl + 1)) != 0) {
+				fl = bitScan(flBitmap & (u32_MAX << (fl + 1)));
+				slMap = slBitmap[fl];
+			}
+
+			if (slMap != 0)
+				return bins[fl][bitScan(slMap)];
+		}
+
+		//The bin of the size itself can still have a range that fits
+		mapping(size, fl, sl);
+
+		for (u32 i = bins[fl][sl]; i != null; i = ranges[i].nextFree)
+			if (ranges[i].size >= size)
+				return i;
+
+		return null;
+	}
+
+	inline bool TLSFAllocator::dealloc(u32 pos) {
+
+		auto it = allocations.find(pos);
+
+		if (it == allocations.end())
+			return false;
+
+		u32 range = it->second;
+		allocations.erase(it);
+
+		//Merge with the next range
+		u32 next = ranges[range].nextPhys;
+
+		if (next != null && ranges[next].isFree) {
+
+			removeFree(next);
+
+			ranges[range].size += ranges[next].size;
+			ranges[range].nextPhys = ranges[next].nextPhys;
+
+			if (ranges[next].nextPhys != null)
+				ranges[ranges[next].nextPhys].prevPhys = range;
+
+			deleteRange(next);
+		}
+
+		//Merge into the previous range
+		u32 prev = ranges[range].prevPhys;
+
+		if (prev != null && ranges[prev].isFree) {
+
+			removeFree(prev);
+
+			ranges[prev].size += ranges[range].size;
+			ranges[prev].nextPhys = ranges[range].nextPhys;
+
+			if (ranges[range].nextPhys != null)
+				ranges[ranges[range].nextPhys].prevPhys = prev;
+
+			deleteRange(range);
+			range = prev;
+		}
+
+		insertFree(range);
+		return true;
+	}
+
+	inline u32 TLSFAllocator::getLargestFree() const {
+
+		if (flBitmap == 0)
+			return 0;
+
+		u32 fl = bitScanReverse(flBitmap), sl = bitScanReverse(slBitmap[fl]);
+
+		u32 largest = 0;
+
+		for (u32 i = bins[fl][sl]; i != null; i = ranges[i].nextFree)
+			if (ranges[i].size > largest)
+				largest = ranges[i].size;
+
+		return largest;
+	}
+
+	//A thread safe block allocator with the interface of BlockAllocator; handles memory (the buffer isn't owned, so it has to outlive the allocator)
+	//Small blocks (up to maxCachedSize) go through a cache per thread, so the lock of the shared allocator is only taken to refill or empty a cache
+	//Refills start at one block and double per miss (up to batchSize), but never take more than 1/freeShare of the free space
+	//If the shared allocator runs out, the blocks that are cached by other threads are taken back before an allocation fails
+	//Blocks can be freed by any thread; dealloc without a size always goes back to the shared allocator
+	class CachingBlockAllocator : TLSFAllocator {
+
+	public:
+
+		static constexpr u32 maxAlignment = 64;					//The start of the buffer is aligned to this
+		static constexpr u32 cacheAlignment = 16;				//Cached blocks are aligned to this
+
+		static constexpr u32 minCachedBits = 4, cacheClasses = 8;
+		static constexpr u32 maxCachedSize = (1U << minCachedBits) << (cacheClasses - 1);
+
+		static constexpr u32 batchSize = 32;					//Most blocks moved between the thread and shared allocator at once
+		static constexpr u32 maxCachedBlocks = batchSize * 2;	//Per class per thread
+		static constexpr u32 freeShare = 16;
+
+		CachingBlockAllocator(Buffer buffer);
+		~CachingBlockAllocator();
+
+		CachingBlockAllocator(const CachingBlockAllocator&) = delete;
+		CachingBlockAllocator &operator=(const CachingBlockAllocator&) = delete;
+
+		//Returns a null buffer if it doesn't fit; alignment has to be a power of two (up to maxAlignment)
+		Buffer alloc(u32 size, u32 alignment = 1);
+
+		//Returns false if the pointer isn't an allocation
+		bool dealloc(u8 *ptr);
+
+		//Size and alignment have to be the ones it was allocated with; small blocks go back to the thread's cache
+		bool dealloc(u8 *ptr, u32 size, u32 alignment = 1);
+
+		template<typename T, typename ...args>
+		T *alloc(args &&...arg) {
+
+			static_assert(alignof(T) <= maxAlignment, "CachingBlockAllocator::alloc<T>; T is aligned beyond maxAlignment");
+
+			u8 *addr = alloc((u32) sizeof(T), (u32) alignof(T)).addr();
+			return addr == nullptr ? nullptr : ::new(addr) T(std::forward<args>(arg)...);
+		}
+
+		template<typename T>
+		bool dealloc(T *t) {
+
+			if (t == nullptr)
+				return false;
+
+			t->~T();
+			return dealloc((u8*) t, (u32) sizeof(T), (u32) alignof(T));
+		}
+
+		//Returns the calling thread's cached blocks to the shared allocator
+		void flush();
+
+		u8 *addr();
+		Buffer getBuffer();
+
+		//Free space of the shared allocator and the blocks in thread caches
+		u32 getFree();
+
+		//Statistics of the shared allocator; blocks in thread caches count as allocated
+		u32 getLargestFree();
+		f32 getFragmentation();
+
+	private:
+
+		struct ThreadCache {
+
+			CachingBlockAllocator *owner = nullptr;
+
+			std::mutex mutex;						//Only contended when another thread takes the blocks back
+			std::vector<u32> blocks[cacheClasses];
+			u32 batch[cacheClasses] = {};			//Size of the last refill
+
+		};
+
+		//Caches of the calling thread; returned to their allocators on thread exit (if they're still alive)
+		struct ThreadCaches {
+
+			std::unordered_map<u64, ThreadCache> caches;		//Allocator id -> cache
+
+			u64 lastId = 0;
+			ThreadCache *last = nullptr;
+
+			~ThreadCaches() {
+
+				std::lock_guard<std::mutex> lock(registryMutex());
+
+				for (auto &elem : caches)
+					if (registry().find(elem.first) != registry().end())
+						elem.second.owner->release(elem.second);
+			}
+
+		};
+
+		static std::mutex &registryMutex() {
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		//Allocators that are alive; ids are never reused, so a cache can't end up at a new allocator at the same address
+		static std::unordered_map<u64, CachingBlockAllocator*> &registry() {
+			static std::unordered_map<u64, CachingBlockAllocator*> allocators;
+			return allocators;
+		}
+
+		static u32 getClass(u32 size) {
+
+			u32 i = 0;
+
+			while (((1U << minCachedBits) << i) < size)
+				++i;
+
+			return i;
+		}
+
+		static u32 getClassSize(u32 c) { return (1U << minCachedBits) << c; }
+
+		static bool isCached(u32 size, u32 alignment) { return size <= maxCachedSize && alignment <= cacheAlignment; }
+
+		static u8 *alignBuffer(Buffer buffer);
+		static u32 alignedLength(Buffer buffer);
+
+		//Lock order: the mutex of a cache before the mutex of the allocator; other threads' caches are only try_locked
+
+		ThreadCache &getCache();
+
+		//Returns the blocks of the cache and detaches it; on thread exit
+		void release(ThreadCache &cache);
+
+		//Requires the cache's and the allocator's lock
+		bool refill(ThreadCache &cache, u32 c);
+		bool empty(ThreadCache &cache);
+
+		//Empties every cache that isn't in use; requires the allocator's lock (and the lock of 'self' if it's not null)
+		bool reclaim(ThreadCache *self);
+
+		Buffer toBuffer(u32 pos, u32 size) { return Buffer::construct(base + pos, size); }
+
+		Buffer buffer;
+		u8 *base;
+		u64 id;
+
+		std::mutex mutex;
+		std::vector<ThreadCache*> caches;
+		std::atomic<u32> cached = { 0 };			//Bytes in thread caches
+
+	};
+
+	//Linear allocator for data that lives for a frame; thread safe and lock free
+	//Allocating is a single atomic add and reset frees everything at once, so destructors aren't called (only trivially destructible types can be allocated)
+	//The buffer isn't owned; it can be a block from a BlockAllocator
+	class FrameAllocator {
+
+	public:
+
+		FrameAllocator(Buffer buffer) : buffer(buffer), length(buffer.size()) {}
+
+		//Returns nullptr if it doesn't fit; alignment has to be a power of two
+		u8 *alloc(u32 size, u32 alignment = 1) {
+
+			uintptr_t start = (uintptr_t) buffer.addr();
+			u64 prev = offset.load(std::memory_order_relaxed), pos;
+
+			do {
+
+				pos = (((u64) start + prev + alignment - 1) & ~(u64)(alignment - 1)) - start;
+
+				if (pos + size > length)
+					return nullptr;
+
+			} while (!offset.compare_exchange_weak(prev, pos + size, std::memory_order_relaxed));
+
+			return buffer.addr() + pos;
+		}
+
+		template<typename T, typename ...args>
+		T *alloc(args &&...arg) {
+
+			static_assert(std::is_trivially_destructible<T>::value, "FrameAllocator::alloc<T>; T has to be trivially destructible, since reset doesn't call destructors");
+
+			u8 *addr = alloc((u32) sizeof(T), (u32) alignof(T));
+			return addr == nullptr ? nullptr : ::new(addr) T(std::forward<args>(arg)...);
+		}
+
+		template<typename T>
+		T *allocArray(u32 count) {
+
+			static_assert(std::is_trivially_destructible<T>::value, "FrameAllocator::allocArray<T>; T has to be trivially destructible, since reset doesn't call destructors");
+
+			if ((u64) sizeof(T) * count > u32_MAX)
+				return nullptr;
+
+			u8 *addr = alloc((u32) sizeof(T) * count, (u32) alignof(T));
+
+			if (addr == nullptr)
+				return nullptr;
+
+			for (u32 i = 0; i < count; ++i)
+				::new(addr + i * sizeof(T)) T();
+
+			return (T*) addr;
+		}
+
+		//Frees everything; nothing can still be allocating or using the memory
+		void reset() { offset.store(0, std::memory_order_relaxed); }
+
+		u32 getUsed() const { return (u32) offset.load(std::memory_order_relaxed); }
+		u32 getFree() const { return length - getUsed(); }
+		u32 size() const { return length; }
+
+	private:
+
+		Buffer buffer;
+		u32 length;
+
+		std::atomic<u64> offset = { 0 };
+
+	};
+
+	inline u8 *CachingBlockAllocator::alignBuffer(Buffer buffer) {
+		uintptr_t start = (uintptr_t) buffer.addr();
+		return (u8*)((start + maxAlignment - 1) & ~(uintptr_t)(maxAlignment - 1));
+	}
+
+	inline u32 CachingBlockAllocator::alignedLength(Buffer buffer) {
+		u32 padding = (u32)(alignBuffer(buffer) - buffer.addr());
+		return buffer.size() > padding ? buffer.size() - padding : 0;
+	}
+
+	inline CachingBlockAllocator::CachingBlockAllocator(Buffer buffer) : TLSFAllocator(alignedLength(buffer)), buffer(buffer), base(alignBuffer(buffer)) {
+
+		static std::atomic<u64> ids = { 0 };
+		id = ++ids;
+
+		std::lock_guard<std::mutex> lock(registryMutex());
+		registry()[id] = this;
+	}
+
+	inline CachingBlockAllocator::~CachingBlockAllocator() {
+
+		//Blocks that are still in thread caches are simply forgotten
+		std::lock_guard<std::mutex> lock(registryMutex());
+		registry().erase(id);
+	}
+
+	inline CachingBlockAllocator::ThreadCache &CachingBlockAllocator::getCache() {
+
+		thread_local ThreadCaches threadCaches;
+
+		if (threadCaches.lastId == id)
+			return *threadCaches.last;
+
+		ThreadCache &cache = threadCaches.caches[id];
+
+		if (cache.owner == nullptr) {
+
+			cache.owner = this;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			caches.push_back(&cache);
+		}
+
+		threadCaches.lastId = id;
+		threadCaches.last = &cache;
+		return cache;
+	}
+
+	inline bool CachingBlockAllocator::empty(ThreadCache &cache) {
+
+		bool any = false;
+
+		for (u32 c = 0; c < cacheClasses; ++c) {
+
+			std::vector<u32> &blocks = cache.blocks[c];
+
+			for (u32 pos : blocks)
+				TLSFAllocator::dealloc(pos);
+
+			any |= !blocks.empty();
+			cached -= (u32) blocks.size() * getClassSize(c);
+
+			blocks.clear();
+			cache.batch[c] = 0;
+		}
+
+		return any;
+	}
+
+	inline void CachingBlockAllocator::release(ThreadCache &cache) {
+
+		std::lock_guard<std::mutex> cacheLock(cache.mutex);
+		std::lock_guard<std::mutex> lock(mutex);
+
+		empty(cache);
+
+		for (u32 i = 0; i < (u32) caches.size(); ++i)
+			if (caches[i] == &cache) {
+				caches[i] = caches.back();
+				caches.pop_back();
+				break;
+			}
+	}
+
+	inline bool CachingBlockAllocator::reclaim(ThreadCache *self) {
+
+		bool any = false;
+
+		for (ThreadCache *cache : caches) {
+
+			if (cache != self && !cache->mutex.try_lock())
+				continue;
+
+			any |= empty(*cache);
+
+			if (cache != self)
+				cache->mutex.unlock();
+		}
+
+		return any;
+	}
+
+	inline bool CachingBlockAllocator::refill(ThreadCache &cache, u32 c) {
+
+		u32 classSize = getClassSize(c);
+		u32 &batch = cache.batch[c];
+
+		batch = batch == 0 ? 1 : (batch * 2 > batchSize ? batchSize : batch * 2);
+
+		u32 share = TLSFAllocator::getFree() / (classSize * freeShare);
+		u32 count = share == 0 ? 1 : (share < batch ? share : batch);
+
+		std::vector<u32> &blocks = cache.blocks[c];
+
+		for (u32 i = 0; i < count; ++i) {
+
+			BlockAllocation block = TLSFAllocator::alloc(classSize, cacheAlignment);
+
+			//Out of space; take the blocks back from the caches and try once more
+			if (block.size == 0 && blocks.empty() && reclaim(&cache))
+				block = TLSFAllocator::alloc(classSize, cacheAlignment);
+
+			if (block.size == 0)
+				break;
+
+			blocks.push_back(block.start);
+		}
+
+		cached += (u32) blocks.size() * classSize;
+		return !blocks.empty();
+	}
+
+	inline Buffer CachingBlockAllocator::alloc(u32 size, u32 alignment) {
+
+		if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment > maxAlignment) {
+			Log::error("CachingBlockAllocator::alloc; size has to be non zero and alignment has to be a power of two up to maxAlignment");
+			return Buffer();
+		}
+
+		if (!isCached(size, alignment)) {
+
+			std::lock_guard<std::mutex> lock(mutex);
+			BlockAllocation block = TLSFAllocator::alloc(size, alignment);
+
+			if (block.size == 0 && reclaim(nullptr))
+				block = TLSFAllocator::alloc(size, alignment);
+
+			return block.size == 0 ? Buffer() : toBuffer(block.start, size);
+		}
+
+		u32 c = getClass(size);
+		ThreadCache &cache = getCache();
+
+		std::lock_guard<std::mutex> cacheLock(cache.mutex);
+		std::vector<u32> &blocks = cache.blocks[c];
+
+		if (blocks.empty()) {
+
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (!refill(cache, c))
+				return Buffer();
+		}
+
+		u32 pos = blocks.back();
+		blocks.pop_back();
+
+		cached -= getClassSize(c);
+		return toBuffer(pos, size);
+	}
+
+	inline bool CachingBlockAllocator::dealloc(u8 *ptr) {
+
+		if (ptr < base || ptr >= base + TLSFAllocator::size())
+			return false;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		return TLSFAllocator::dealloc((u32)(ptr - base));
+	}
+
+	inline bool CachingBlockAllocator::dealloc(u8 *ptr, u32 size, u32 alignment) {
+
+		if (!isCached(size, alignment))
+			return dealloc(ptr);
+
+		if (ptr < base || ptr >= base + TLSFAllocator::size())
+			return false;
+
+		u32 c = getClass(size), classSize = getClassSize(c);
+		ThreadCache &cache = getCache();
+
+		std::lock_guard<std::mutex> cacheLock(cache.mutex);
+		std::vector<u32> &blocks = cache.blocks[c];
+
+		blocks.push_back((u32)(ptr - base));
+		cached += classSize;
+
+		//Return the oldest half, so the recently used blocks stay
+		if (blocks.size() > maxCachedBlocks) {
+
+			std::lock_guard<std::mutex> lock(mutex);
+
+			for (u32 i = 0; i < batchSize; ++i)
+				TLSFAllocator::dealloc(blocks[i]);
+
+			blocks.erase(blocks.begin(), blocks.begin() + batchSize);
+			cached -= batchSize * classSize;
+		}
+
+		return true;
+	}
+
+	inline void CachingBlockAllocator::flush() {
+
+		ThreadCache &cache = getCache();
+
+		std::lock_guard<std::mutex> cacheLock(cache.mutex);
+		std::lock_guard<std::mutex> lock(mutex);
+		empty(cache);
+	}
+
+	inline u8 *CachingBlockAllocator::addr() { return base; }
+	inline Buffer CachingBlockAllocator::getBuffer() { return buffer; }
+
+	inline u32 CachingBlockAllocator::getFree() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return TLSFAllocator::getFree() + cached;
+	}
+
+	inline u32 CachingBlockAllocator::getLargestFree() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return TLSFAllocator::getLargestFree();
+	}
+
+	inline f32 CachingBlockAllocator::getFragmentation() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return TLSFAllocator::getFragmentation();
+	}
+
 }
\ No newline at end of file
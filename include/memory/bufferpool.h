@@ -0,0 +1,132 @@
+#pragma once
+
+#include "types/generic.h"
+#include <cstdlib>
+#include <mutex>
+
+namespace oi {
+
+	//Size class pool for buffer memory; thread safe
+	//Blocks are rounded up to a power of two (64 B - 1 MiB) and kept around when they're freed, so pipelines that allocate the same sizes repeatedly stop hitting the heap
+	//Bigger blocks are allocated and freed directly
+	class BufferPool {
+
+	public:
+
+		static constexpr u32 minClassBits = 6;
+		static constexpr u32 classes = 15;
+		static constexpr u32 maxCached = 16;						//Free blocks kept per size class
+
+		static constexpr u64 minClassSize = 1ULL << minClassBits;
+		static constexpr u64 maxClassSize = minClassSize << (classes - 1);
+
+		//Returns nullptr if it couldn't be allocated; capacity is the real size of the block
+		static u8 *alloc(u64 size, u64 &capacity) {
+
+			u32 i = getClass(size);
+
+			if (i == classes) {
+				capacity = size;
+				return (u8*) std::malloc((size_t) size);
+			}
+
+			capacity = minClassSize << i;
+
+			SizeClass &sc = get().sizeClasses[i];
+
+			{
+				std::lock_guard<std::mutex> lock(sc.mutex);
+
+				if (sc.count != 0)
+					return sc.blocks[--sc.count];
+			}
+
+			return (u8*) std::malloc((size_t) capacity);
+		}
+
+		//The capacity has to be the one returned by alloc
+		static void free(u8 *ptr, u64 capacity) {
+
+			if (ptr == nullptr)
+				return;
+
+			u32 i = getClass(capacity);
+
+			if (i != classes) {
+
+				SizeClass &sc = get().sizeClasses[i];
+				std::lock_guard<std::mutex> lock(sc.mutex);
+
+				if (sc.count != maxCached) {
+					sc.blocks[sc.count++] = ptr;
+					return;
+				}
+			}
+
+			std::free(ptr);
+		}
+
+		//Frees all cached blocks
+		static void trim() { get().clear(); }
+
+		//Bytes kept in the free lists
+		static u64 getCached() {
+
+			u64 res = 0;
+
+			for (u32 i = 0; i < classes; ++i) {
+				SizeClass &sc = get().sizeClasses[i];
+				std::lock_guard<std::mutex> lock(sc.mutex);
+				res += sc.count * (minClassSize << i);
+			}
+
+			return res;
+		}
+
+	private:
+
+		struct SizeClass {
+			std::mutex mutex;
+			u8 *blocks[maxCached];
+			u32 count = 0;
+		};
+
+		SizeClass sizeClasses[classes];
+
+		void clear() {
+
+			for (SizeClass &sc : sizeClasses) {
+
+				std::lock_guard<std::mutex> lock(sc.mutex);
+
+				for (u32 i = 0; i < sc.count; ++i)
+					std::free(sc.blocks[i]);
+
+				sc.count = 0;
+			}
+		}
+
+		//Never destroyed; buffers in statics can be freed after every other static is destroyed
+		//The cached blocks are returned to the OS when the process exits
+		static BufferPool &get() {
+			static BufferPool *pool = new BufferPool();
+			return *pool;
+		}
+
+		//Smallest class that fits; classes if it doesn't fit any
+		static u32 getClass(u64 size) {
+
+			if (size > maxClassSize)
+				return classes;
+
+			u32 i = 0;
+
+			while ((minClassSize << i) < size)
+				++i;
+
+			return i;
+		}
+
+	};
+
+}
\ No newline at end of file
@@ -4,7 +4,11 @@
 #include "types/string.h"
 #include "templatefuncs.h"
 #include "utils/log.h"
+#include "utils/hash.h"
 #include <string.h>
+#include <string_view>
+#include <array>
+#include <type_traits>
 
 //Note for enums:
 //Please make sure that names are standard C/C++ names (so no spaces/tabs; no starting with numbers, etc.)
@@ -15,6 +19,149 @@
 
 namespace oi {
 
+	//Compile time lookup tables for enums; so converting between names, values and indices is O(1) and doesn't allocate
+	namespace EnumHelper {
+
+		//Names are the identifiers in front of every '=' in the stringified enum arguments ("A = 0, B = 1")
+		//Lookup is an open addressing table (linear probing) on Hash::fnv1a
+		template<u32 n>
+		struct NameTable {
+
+			static constexpr u32 slots = Hash::slots(n);
+
+			std::array<std::string_view, n> names = {};
+			u32 table[slots] = {};				//Index + 1; 0 = empty
+
+			constexpr NameTable(std::string_view args) {
+
+				u32 k = 0;
+
+				for (size_t i = 0; i < args.size() && k < n; ++i) {
+
+					if (args[i] != '=')
+						continue;
+
+					size_t end = i, start = 0;
+
+					while (end > 0 && (args[end - 1] == ' ' || args[end - 1] == '\t' || args[end - 1] == '\r' || args[end - 1] == '\n'))
+						--end;
+
+					for (start = end; start > 0 && isIdentifier(args[start - 1]); --start);
+
+					names[k] = args.substr(start, end - start);
+					++k;
+				}
+
+				for (u32 i = 0; i < n; ++i) {
+
+					u32 j = Hash::fnv1a(names[i]) & (slots - 1);
+
+					for (; table[j] != 0; j = (j + 1) & (slots - 1))
+						if (names[table[j] - 1] == names[i])
+							break;
+
+					if (table[j] == 0)
+						table[j] = i + 1;
+				}
+			}
+
+			//Returns index + 1 or 0 if it doesn't exist
+			constexpr u32 find(std::string_view str) const {
+
+				for (u32 j = Hash::fnv1a(str) & (slots - 1); table[j] != 0; j = (j + 1) & (slots - 1))
+					if (names[table[j] - 1] == str)
+						return table[j];
+
+				return 0;
+			}
+
+			static constexpr bool isIdentifier(char c) {
+				return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+			}
+
+		};
+
+		template<typename T, typename = void> struct HasIntegralValue : std::false_type {};
+		template<typename T> struct HasIntegralValue<T, std::void_t<decltype(T::value)>> : std::is_integral<decltype(T::value)> {};
+
+		//Value to index; structured enums are compared by memory
+		template<typename T, u32 n, bool integral = HasIntegralValue<T>::value>
+		struct ValueTable {
+
+			constexpr ValueTable(const T*) {}
+
+			//Returns index + 1 or 0 if it doesn't exist
+			u32 find(const T *values, const T &val) const {
+
+				for (u32 i = 0; i < n; ++i)
+					if (memcmp(values + i, &val, sizeof(val)) == 0)
+						return i + 1;
+
+				return 0;
+			}
+
+		};
+
+		//Data enums; indexed directly by (value - min) if the values are dense, otherwise hashed (linear probing)
+		template<typename T, u32 n>
+		struct ValueTable<T, n, true> {
+
+			static constexpr u32 slots = Hash::slots(n);
+
+			u64 min = 0;
+			bool dense = true;
+			u32 table[slots] = {};				//Index + 1; 0 = empty
+
+			constexpr ValueTable(const T *values) {
+
+				auto mn = values[0].value, mx = values[0].value;
+
+				for (u32 i = 1; i < n; ++i) {
+					if (values[i].value < mn) mn = values[i].value;
+					if (values[i].value > mx) mx = values[i].value;
+				}
+
+				min = (u64) mn;
+				dense = (u64) mx - min < slots;
+
+				for (u32 i = 0; i < n; ++i) {
+
+					u32 j = slot((u64) values[i].value);
+
+					for (; table[j] != 0; j = (j + 1) & (slots - 1))
+						if (values[table[j] - 1].value == values[i].value)
+							break;
+
+					if (table[j] == 0)
+						table[j] = i + 1;
+				}
+			}
+
+			//Returns index + 1 or 0 if it doesn't exist
+			constexpr u32 find(const T *values, const T &val) const {
+
+				u64 v = (u64) val.value;
+
+				if (dense)
+					return v - min < slots ? table[v - min] : 0;
+
+				for (u32 j = slot(v); table[j] != 0; j = (j + 1) & (slots - 1))
+					if (values[table[j] - 1].value == val.value)
+						return table[j];
+
+				return 0;
+			}
+
+		private:
+
+			constexpr u32 slot(u64 v) const {
+				return dense ? (u32)(v - min) : (u32)((v * 0x9E3779B97F4A7C15ULL) >> 32) & (slots - 1);
+			}
+
+		};
+
+	}
+
 	#define _(...) __VA_ARGS__
 
 	//Structured enum (constexpr)
@@ -44,23 +191,19 @@ namespace oi {
 		}																							\
 																									\
 		name(const name##_s val) : index(0) {														\
-			for (u32 i = 0; i < length; ++i)														\
-				if (memcmp(ilist + i, &val, sizeof(val)) == 0) {									\
-					index = i;																		\
-					break;																			\
-				}																					\
+			u32 i = valueTable.find(ilist, val);													\
+			if (i != 0) index = i - 1;																\
 		}																							\
 																									\
-		name(oi::String name) : index(0) {															\
-																									\
-			for (u32 i = 0; i < length; ++i)														\
-			if (getNames()[i] == name) {															\
-				index = i;																			\
-				break;																				\
-			}																						\
-																									\
+		name(std::string_view str) : index(0) {														\
+			u32 i = nameTable.find(str);															\
+			if (i != 0) index = i - 1;																\
 		}																							\
 																									\
+		template<size_t n>																			\
+		name(const char (&str)[n]) : name(std::string_view(str)) {}									\
+		name(const oi::String &str) : name(std::string_view(str.toCString(), str.size())) {}		\
+																									\
 		bool operator==(const name &other) const {													\
 			return index == other.index;															\
 		}																							\
@@ -83,6 +226,7 @@ namespace oi {
 		u32 getIndex() const { return index; }														\
 																									\
 		const oi::String getName() const { return getNames()[index]; }								\
+		std::string_view getNameView() const { return nameTable.names[index]; }					\
 																									\
 		static std::vector<name##_s> getValues() {													\
 			auto vec = std::vector<name##_s>(length);												\
@@ -95,6 +239,10 @@ namespace oi {
 			return names;																			\
 		}																							\
 																									\
+		static constexpr const std::array<std::string_view, length> &getNameViews() {				\
+			return nameTable.names;																	\
+		}																							\
+																									\
 		static const oi::String &getEnumName() {													\
 			static const oi::String name = #name;													\
 			return name;																			\
@@ -107,37 +255,17 @@ namespace oi {
 	protected:																						\
 																									\
 		static const std::vector<oi::String> initNames() {											\
-																									\
-			std::vector<oi::String> res;															\
-			std::vector<oi::String> arr = getArgs().split("=");										\
-																									\
-			u32 i = 0;																				\
-			for (oi::String &temp : arr) {															\
-																									\
-				if (i == 0){																		\
-					std::vector<oi::String> csplit2 = temp.split("(");								\
-					res.push_back(csplit2[csplit2.size() - 1]);										\
-				}																					\
-				else if (i < arr.size() - 1) {														\
-					std::vector<oi::String> csplit = temp.split(",");								\
-					oi::String almostCorrect = csplit[csplit.size() - 1];							\
-					std::vector<oi::String> csplit2 = almostCorrect.split("(");						\
-					res.push_back(csplit2[csplit2.size() - 1]);										\
-				}																					\
-																									\
-				++i;																				\
-			}																						\
-																									\
+			std::vector<oi::String> res(length);													\
+			for (u32 i = 0; i < length; ++i)														\
+				res[i] = oi::String(nameTable.names[i]);											\
 			return res;																				\
 		}																							\
 																									\
-		static const oi::String &getArgs() {														\
-			static const oi::String args = (oi::String(#a0) + ", " + oi::String(#__VA_ARGS__)).replace(" ", "").replace("\t", "").replace("\r", "").replace("\n", "");	\
-			return args;																			\
-		}																							\
-																									\
 	private:																						\
 																									\
+		static constexpr oi::EnumHelper::NameTable<length> nameTable = { #a0 ", " #__VA_ARGS__ };	\
+		static constexpr oi::EnumHelper::ValueTable<name##_s, length> valueTable = { ilist };		\
+																									\
 		u32 index;																					\
 																									\
 	};
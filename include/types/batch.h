@@ -0,0 +1,150 @@
+#pragma once
+
+#include "matrix.h"
+
+namespace oi {
+
+	//A lane of f32s; the batched kernels are written once against this interface
+	struct F32x1 {
+
+		static constexpr u32 width = 1;
+
+		f32 v;
+
+		static F32x1 load(const f32 *ptr) { return { *ptr }; }
+		static F32x1 set(f32 val) { return { val }; }
+		void store(f32 *ptr) const { *ptr = v; }
+
+		F32x1 operator+(const F32x1 &other) const { return { v + other.v }; }
+		F32x1 operator*(const F32x1 &other) const { return { v * other.v }; }
+
+	};
+
+	#ifdef __SIMD_SSE__
+
+	struct F32x4 {
+
+		static constexpr u32 width = 4;
+
+		__m128 v;
+
+		static F32x4 load(const f32 *ptr) { return { _mm_loadu_ps(ptr) }; }
+		static F32x4 set(f32 val) { return { _mm_set1_ps(val) }; }
+		void store(f32 *ptr) const { _mm_storeu_ps(ptr, v); }
+
+		F32x4 operator+(const F32x4 &other) const { return { _mm_add_ps(v, other.v) }; }
+		F32x4 operator*(const F32x4 &other) const { return { _mm_mul_ps(v, other.v) }; }
+
+	};
+
+	#elif defined(__SIMD_NEON__)
+
+	struct F32x4 {
+
+		static constexpr u32 width = 4;
+
+		float32x4_t v;
+
+		static F32x4 load(const f32 *ptr) { return { vld1q_f32(ptr) }; }
+		static F32x4 set(f32 val) { return { vdupq_n_f32(val) }; }
+		void store(f32 *ptr) const { vst1q_f32(ptr, v); }
+
+		F32x4 operator+(const F32x4 &other) const { return { vaddq_f32(v, other.v) }; }
+		F32x4 operator*(const F32x4 &other) const { return { vmulq_f32(v, other.v) }; }
+
+	};
+
+	#endif
+
+	#ifdef __SIMD_AVX__
+
+	struct F32x8 {
+
+		static constexpr u32 width = 8;
+
+		__m256 v;
+
+		static F32x8 load(const f32 *ptr) { return { _mm256_loadu_ps(ptr) }; }
+		static F32x8 set(f32 val) { return { _mm256_set1_ps(val) }; }
+		void store(f32 *ptr) const { _mm256_storeu_ps(ptr, v); }
+
+		F32x8 operator+(const F32x8 &other) const { return { _mm256_add_ps(v, other.v) }; }
+		F32x8 operator*(const F32x8 &other) const { return { _mm256_mul_ps(v, other.v) }; }
+
+	};
+
+	typedef F32x8 F32xN;
+
+	#elif defined(__SIMD_SSE__) || defined(__SIMD_NEON__)
+
+	typedef F32x4 F32xN;
+
+	#else
+
+	typedef F32x1 F32xN;
+
+	#endif
+
+	//Transforms many elements at once
+	//Points and normals are stored as SoA streams (x[], y[], z[]); so every lane of a register is a different element
+	//Output streams may be the same as the input streams
+	struct Batch {
+
+		//o = (m * (x, y, z, 1)).xyz; the w row is ignored, so it's meant for affine matrices
+		static void transformPoints(const Matrixf &m, const f32 *x, const f32 *y, const f32 *z, f32 *ox, f32 *oy, f32 *oz, u32 count) {
+			u32 i = transform<F32xN>(m, 1, x, y, z, ox, oy, oz, 0, count);
+			transform<F32x1>(m, 1, x, y, z, ox, oy, oz, i, count);
+		}
+
+		//o = (m * (x, y, z, 0)).xyz; normals have to be transformed by the inverse transpose if m has non uniform scale
+		static void transformNormals(const Matrixf &m, const f32 *x, const f32 *y, const f32 *z, f32 *ox, f32 *oy, f32 *oz, u32 count) {
+			u32 i = transform<F32xN>(m, 0, x, y, z, ox, oy, oz, 0, count);
+			transform<F32x1>(m, 0, x, y, z, ox, oy, oz, i, count);
+		}
+
+		//res[i] = a[i] * b[i]
+		static void multiply(const Matrixf *a, const Matrixf *b, Matrixf *res, u32 count) {
+			for (u32 i = 0; i < count; ++i)
+				MatrixOps<f32, 4, 4>::mul(a[i].f, b[i].f, res[i].f);
+		}
+
+		//res[i] = a * b[i]; for example a parent transform applied to its children
+		static void multiply(const Matrixf &a, const Matrixf *b, Matrixf *res, u32 count) {
+			for (u32 i = 0; i < count; ++i)
+				MatrixOps<f32, 4, 4>::mul(a.f, b[i].f, res[i].f);
+		}
+
+		//res[i] = Matrixf::makeModel(pos[i], rot[i], scale[i]); rotations are in degrees
+		static void makeModels(const Vec3f *pos, const Vec3f *rot, const Vec3f *scale, Matrixf *res, u32 count) {
+			for (u32 i = 0; i < count; ++i)
+				res[i] = Matrixf::makeModel(pos[i], rot[i], scale[i]);
+		}
+
+	private:
+
+		//Transforms [start, end) in steps of the lane width; returns where it stopped (the remainder is left for the tail)
+		template<typename L>
+		static u32 transform(const Matrixf &m, f32 w, const f32 *x, const f32 *y, const f32 *z, f32 *ox, f32 *oy, f32 *oz, u32 start, u32 end) {
+
+			L m00 = L::set(m.m[0][0]), m01 = L::set(m.m[0][1]), m02 = L::set(m.m[0][2]);
+			L m10 = L::set(m.m[1][0]), m11 = L::set(m.m[1][1]), m12 = L::set(m.m[1][2]);
+			L m20 = L::set(m.m[2][0]), m21 = L::set(m.m[2][1]), m22 = L::set(m.m[2][2]);
+			L t0 = L::set(m.m[3][0] * w), t1 = L::set(m.m[3][1] * w), t2 = L::set(m.m[3][2] * w);
+
+			u32 i = start;
+
+			for (; i + L::width <= end; i += L::width) {
+
+				L vx = L::load(x + i), vy = L::load(y + i), vz = L::load(z + i);
+
+				(m00 * vx + m10 * vy + m20 * vz + t0).store(ox + i);
+				(m01 * vx + m11 * vy + m21 * vz + t1).store(oy + i);
+				(m02 * vx + m12 * vy + m22 * vz + t2).store(oz + i);
+			}
+
+			return i;
+		}
+
+	};
+
+}
\ No newline at end of file
@@ -1,7 +1,12 @@
 #pragma once
 
 #include "utils/binaryhelper.h"
+#include "memory/bufferpool.h"
 #include "string.h"
+#include "utils/log.h"
+#include "utils/bitstream.h"
+#include <atomic>
+#include <cstring>
 
 namespace oi {
 
@@ -86,4 +91,248 @@ namespace oi {
 		CopyBuffer &copy(const CopyBuffer &cb);
 	};
 
+	class SharedBuffer;
+
+	//Data of UniqueBuffer and SharedBuffer; allocated through the BufferPool with the data right behind it
+	struct BufferBlock {
+
+		std::atomic<u32> refs;
+		u64 capacity;										//Of the data
+
+		u8 *data() { return (u8*)(this + 1); }
+
+		static BufferBlock *alloc(u64 size) {
+
+			u64 capacity;
+			u8 *ptr = BufferPool::alloc(size + sizeof(BufferBlock), capacity);
+
+			if (ptr == nullptr)
+				return nullptr;
+
+			return ::new(ptr) BufferBlock{ { 1 }, capacity - sizeof(BufferBlock) };
+		}
+
+		static void free(BufferBlock *block) {
+			if (block != nullptr)
+				BufferPool::free((u8*) block, block->capacity + sizeof(BufferBlock));
+		}
+
+	};
+
+	static_assert(sizeof(BufferBlock) == 16, "BufferBlock has to keep the data 16 byte aligned");
+
+	//!UniqueBuffer owns its data; it can only be moved and frees (returns it to the pool) when it goes out of scope
+	class UniqueBuffer {
+
+		friend class SharedBuffer;
+
+	public:
+
+		UniqueBuffer() {}
+
+		//Uninitialized data
+		explicit UniqueBuffer(u64 size) : block(BufferBlock::alloc(size)), length(block ? size : 0) {}
+
+		//Copies the data
+		UniqueBuffer(const u8 *dat, u64 size) : UniqueBuffer(size) {
+			if (length != 0)
+				memcpy(addr(), dat, (size_t) size);
+		}
+
+		~UniqueBuffer() { BufferBlock::free(block); }
+
+		UniqueBuffer(const UniqueBuffer&) = delete;
+		UniqueBuffer &operator=(const UniqueBuffer&) = delete;
+
+		UniqueBuffer(UniqueBuffer &&other) : block(other.block), length(other.length) {
+			other.block = nullptr;
+			other.length = 0;
+		}
+
+		UniqueBuffer &operator=(UniqueBuffer &&other) {
+
+			if (this != &other) {
+				BufferBlock::free(block);
+				block = other.block;
+				length = other.length;
+				other.block = nullptr;
+				other.length = 0;
+			}
+
+			return *this;
+		}
+
+		u8 *addr() { return block ? block->data() : nullptr; }
+		const u8 *addr() const { return block ? block->data() : nullptr; }
+
+		u64 size() const { return length; }
+		u64 capacity() const { return block ? block->capacity : 0; }
+		bool empty() const { return length == 0; }
+
+		//Keeps the data; only reallocates if it doesn't fit the capacity
+		bool resize(u64 size) {
+
+			if (size <= capacity()) {
+				length = size;
+				return true;
+			}
+
+			UniqueBuffer res(size);
+
+			if (res.block == nullptr)
+				return Log::error("UniqueBuffer::resize; couldn't allocate");
+
+			if (length != 0)
+				memcpy(res.addr(), addr(), (size_t) length);
+
+			return (*this = std::move(res)), true;
+		}
+
+		void reset() { *this = UniqueBuffer(); }
+
+		//Non-owning Buffer for the existing (32-bit) interfaces; it's only valid as long as this buffer is
+		Buffer view() const;
+
+	private:
+
+		static Buffer toBuffer(u8 *ptr, u64 length) {
+
+			if (length > u32_MAX) {
+				Log::error("Buffer can't view more than 4 GiB; use the 64-bit interface instead");
+				return {};
+			}
+
+			return Buffer::construct(ptr, (u32) length);
+		}
+
+		BufferBlock *block = nullptr;
+		u64 length = 0;
+
+	};
+
+	//!SharedBuffer is a ref counted view into data; copying it and taking sub views doesn't copy the data
+	//The data is freed (returned to the pool) when the last view is gone
+	class SharedBuffer {
+
+	public:
+
+		SharedBuffer() {}
+
+		SharedBuffer(UniqueBuffer &&buf) : block(buf.block), ptr(buf.addr()), length(buf.length) {
+			buf.block = nullptr;
+			buf.length = 0;
+		}
+
+		~SharedBuffer() { release(); }
+
+		SharedBuffer(const SharedBuffer &other) : block(other.block), ptr(other.ptr), length(other.length) {
+			if (block != nullptr)
+				block->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		SharedBuffer(SharedBuffer &&other) : block(other.block), ptr(other.ptr), length(other.length) {
+			other.block = nullptr;
+			other.ptr = nullptr;
+			other.length = 0;
+		}
+
+		SharedBuffer &operator=(SharedBuffer other) {
+			std::swap(block, other.block);
+			std::swap(ptr, other.ptr);
+			std::swap(length, other.length);
+			return *this;
+		}
+
+		//Views into the same data; out of bounds returns an empty buffer
+		SharedBuffer subbuffer(u64 offset, u64 size) const {
+
+			if (offset > length || size > length - offset) {
+				Log::error("SharedBuffer::subbuffer; out of bounds");
+				return {};
+			}
+
+			return SharedBuffer(*this, ptr + offset, size);
+		}
+
+		SharedBuffer offset(u64 i) const { return subbuffer(i, i > length ? 0 : length - i); }
+
+		//Writes are visible to all views of the data
+		u8 *addr() const { return ptr; }
+		u64 size() const { return length; }
+		bool empty() const { return length == 0; }
+
+		u32 useCount() const { return block ? block->refs.load(std::memory_order_relaxed) : 0; }
+
+		void reset() { *this = SharedBuffer(); }
+
+		//Non-owning Buffer for the existing (32-bit) interfaces; it's only valid as long as this view is
+		Buffer view() const;
+
+	private:
+
+		SharedBuffer(const SharedBuffer &other, u8 *ptr, u64 length) : SharedBuffer(other) {
+			this->ptr = ptr;
+			this->length = length;
+		}
+
+		void release() {
+			if (block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				BufferBlock::free(block);
+		}
+
+		BufferBlock *block = nullptr;
+		u8 *ptr = nullptr;
+		u64 length = 0;
+
+	};
+
+	inline Buffer UniqueBuffer::view() const { return toBuffer((u8*) addr(), length); }
+	inline Buffer SharedBuffer::view() const { return UniqueBuffer::toBuffer(ptr, length); }
+
+	//Word at a time String::encode/decode (utils/bitstream.h); perChar is 1-32 bits and symbols are packed most significant bit first
+	//Symbols are indices into the charset
+	struct StringPacking {
+
+		static String decode(Buffer buf, const String &charset, u8 perChar) {
+			return perChar == 0 ? String() : decode(buf, charset, perChar, buf.size() * 8 / perChar);
+		}
+
+		static String decode(Buffer buf, const String &charset, u8 perChar, u32 length) {
+
+			if (perChar == 0 || perChar > 32 || BitPacking::getBytes(length, perChar) > buf.size()) {
+				Log::error("StringPacking::decode; the buffer is too small or perChar is invalid");
+				return {};
+			}
+
+			std::string res(length, '\0');
+
+			if (!BitPacking::decode(buf.addr(), perChar, charset.toCString(), charset.size(), &res[0], length)) {
+				Log::error("StringPacking::decode; symbol out of the charset");
+				return {};
+			}
+
+			return String(std::move(res));
+		}
+
+		//Allocates a new buffer, make sure to deconstruct it
+		static Buffer encode(const String &str, const String &charset, u8 perChar) {
+
+			if (perChar == 0 || perChar > 32) {
+				Log::error("StringPacking::encode; perChar is invalid");
+				return {};
+			}
+
+			Buffer buf((u32) BitPacking::getBytes(str.size(), perChar));
+
+			if (!BitPacking::encode(str.toCString(), str.size(), charset.toCString(), charset.size(), perChar, buf.addr())) {
+				buf.deconstruct();
+				Log::error("StringPacking::encode; character isn't in the charset");
+				return {};
+			}
+
+			return buf;
+		}
+
+	};
+
 }
\ No newline at end of file
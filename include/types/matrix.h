@@ -180,14 +180,26 @@ namespace oi {
 		}
 
 		TMatrix operator*(const TMatrix &other) const {
-
 			TMatrix m;
+			MatrixOps<T, w, h>::mul(this->f, other.f, m.f);
+			return m;
+		}
 
-			for (int i = 0; i < 4; i++)
-				for (int j = 0; j < 4; j++)
-					m.m[i][j] = horizontal(j).dot(other.vertical(i));
+		TVec<T, h> operator*(const TVec<T, w> &v) const {
+			TVec<T, h> res;
+			MatrixOps<T, w, h>::mulVec(this->f, v.arr, res.arr);
+			return res;
+		}
 
-			return m;
+		//Returns a zero matrix if it can't be inverted
+		TMatrix inverse() const {
+
+			TMatrix res;
+
+			if (!MatrixOps<T, w, h>::inverse(this->f, res.f))
+				memset(res.f, 0, sizeof(res.f));
+
+			return res;
 		}
 
 		bool operator==(const TMatrix &other) const {
@@ -284,7 +296,32 @@ namespace oi {
 
 			static_assert(w == 4 && h == 4, "TMatrix::makeModel is only available on TMatrix4x4");
 
-			return makeTranslate(pos) * makeRotate(drot) * makeScale(TVec4<T>(scl, (T) 1));
+			//translate * rotateX * rotateY * rotateZ * scale; composed directly
+			TVec3<T> r = drot / 180.f * 3.1415926535f;
+
+			T cx = (T) cos(r.x), sx = (T) sin(r.x);
+			T cy = (T) cos(r.y), sy = (T) sin(r.y);
+			T cz = (T) cos(r.z), sz = (T) sin(r.z);
+
+			TMatrix m;
+
+			m.m[0][0] = cy * cz * scl.x;
+			m.m[0][1] = (cx * sz + sx * sy * cz) * scl.x;
+			m.m[0][2] = (sx * sz - cx * sy * cz) * scl.x;
+
+			m.m[1][0] = -cy * sz * scl.y;
+			m.m[1][1] = (cx * cz - sx * sy * sz) * scl.y;
+			m.m[1][2] = (sx * cz + cx * sy * sz) * scl.y;
+
+			m.m[2][0] = sy * scl.z;
+			m.m[2][1] = -sx * cy * scl.z;
+			m.m[2][2] = cx * cy * scl.z;
+
+			m.m[3][0] = pos.x;
+			m.m[3][1] = pos.y;
+			m.m[3][2] = pos.z;
+
+			return m;
 		}
 
 		static TMatrix makeView(TVec3<T> eye, TVec3<T> center, TVec3<T> up) {
@@ -315,11 +352,7 @@ namespace oi {
 		TMatrix<T, h, w> transpose() const {
 
 			TMatrix<T, h, w> res;
-
-			for (u32 i = 0; i < w; ++i)
-				for (u32 j = 0; j < h; ++j)
-					res.m[j][i] = this->m[i][j];
-
+			MatrixOps<T, w, h>::transpose(this->f, res.f);
 			return res;
 		}
 
@@ -0,0 +1,302 @@
+#pragma once
+
+#include "generic.h"
+#include "api/rapidjson/internal/itoa.h"
+#include "api/rapidjson/internal/dtoa.h"
+#include "api/rapidjson/internal/strtod.h"
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+namespace oi {
+
+	//Locale independent number conversion (through rapidjson's itoa, Grisu2 dtoa and strtod)
+	//format writes the characters (without null terminator) and returns the end
+	//parse requires the entire string to be the number and returns false if it isn't (or if it doesn't fit)
+	class Number {
+
+	public:
+
+		static constexpr u32 maxChars = 32;						//Buffer size that fits any formatted number
+
+		static char *format(i32 i, char *buffer) { return rapidjson::internal::i32toa(i, buffer); }
+		static char *format(u32 u, char *buffer) { return rapidjson::internal::u32toa(u, buffer); }
+		static char *format(i64 i, char *buffer) { return rapidjson::internal::i64toa(i, buffer); }
+		static char *format(u64 u, char *buffer) { return rapidjson::internal::u64toa(u, buffer); }
+
+		//Shortest representation that parses back to the same double; integral values don't get a ".0"
+		static char *format(f64 f, char *buffer) {
+
+			if (char *special = formatSpecial(f, buffer))
+				return special;
+
+			if (f < 0) {
+				*buffer++ = '-';
+				f = -f;
+			}
+
+			int length, k;
+			rapidjson::internal::Grisu2(f, buffer, &length, &k);
+			return prettify(buffer, length, k);
+		}
+
+		//Shortest representation that parses back to the same float
+		static char *format(f32 f, char *buffer) {
+
+			if (char *special = formatSpecial(f, buffer))
+				return special;
+
+			if (f < 0) {
+				*buffer++ = '-';
+				f = -f;
+			}
+
+			//The digits of the double are rounded until the float doesn't survive anymore
+			int length, k;
+			char digits[24];
+			rapidjson::internal::Grisu2((f64) f, digits, &length, &k);
+
+			for (int n = 1; n <= length; ++n) {
+
+				int count = n, exp = k + length - n;
+				memcpy(buffer, digits, (size_t) n);
+
+				if (n < length && digits[n] >= '5') {
+
+					int i = n - 1;
+
+					while (i >= 0 && buffer[i] == '9')
+						buffer[i--] = '0';
+
+					if (i < 0) {					//999 -> 1000
+						buffer[0] = '1';
+						exp += count;
+						count = 1;
+					} else
+						++buffer[i];
+				}
+
+				while (count > 1 && buffer[count - 1] == '0') {
+					--count;
+					++exp;
+				}
+
+				if ((f32) toDouble(buffer, (u32) count, exp) == f)
+					return prettify(buffer, count, exp);
+			}
+
+			return prettify(buffer, length, k);
+		}
+
+		static bool parse(const char *str, u32 len, u64 &res) {
+
+			if (len != 0 && *str == '+') {
+				++str;
+				--len;
+			}
+
+			if (len == 0)
+				return false;
+
+			u64 val = 0;
+
+			for (u32 i = 0; i < len; ++i) {
+
+				u32 digit = (u32)(str[i] - '0');
+
+				if (digit > 9 || val > (u64_MAX - digit) / 10)
+					return false;
+
+				val = val * 10 + digit;
+			}
+
+			res = val;
+			return true;
+		}
+
+		static bool parse(const char *str, u32 len, i64 &res) {
+
+			bool neg = len != 0 && *str == '-';
+			u64 val;
+
+			if (!parse(str + (neg ? 1 : 0), len - (neg ? 1 : 0), val) || (neg && str[1] == '+') || val > (u64) i64_MAX + (neg ? 1 : 0))
+				return false;
+
+			res = neg ? (i64)(0 - val) : (i64) val;
+			return true;
+		}
+
+		static bool parse(const char *str, u32 len, u32 &res) {
+
+			u64 val;
+
+			if (!parse(str, len, val) || val > u32_MAX)
+				return false;
+
+			res = (u32) val;
+			return true;
+		}
+
+		static bool parse(const char *str, u32 len, i32 &res) {
+
+			i64 val;
+
+			if (!parse(str, len, val) || val > i32_MAX || val < i32_MIN)
+				return false;
+
+			res = (i32) val;
+			return true;
+		}
+
+		//[+-]digits[.digits][(e|E)[+-]digits]; digits are optional on one side of the dot
+		static bool parse(const char *str, u32 len, f64 &res, bool allowExponent = true) {
+
+			const char *end = str + len;
+			bool neg = false;
+
+			if (str != end && (*str == '-' || *str == '+'))
+				neg = *str++ == '-';
+
+			//Significant digits (without leading zeros); only the first maxDigits are used
+			static constexpr u32 maxDigits = 768;
+
+			char digits[maxDigits];
+			u32 count = 0, mantissa = 0;
+			i64 decimalPosition = 0, exp = 0;
+			bool dot = false;
+
+			for (; str != end; ++str) {
+
+				if (*str == '.' && !dot) {
+					dot = true;
+					continue;
+				}
+
+				if (*str < '0' || *str > '9')
+					break;
+
+				++mantissa;
+
+				if (*str == '0' && count == 0) {
+					if (dot) --decimalPosition;
+					continue;
+				}
+
+				if (count < maxDigits)
+					digits[count++] = *str;
+
+				if (!dot)
+					++decimalPosition;
+			}
+
+			if (mantissa == 0)
+				return false;
+
+			if (str != end && (*str == 'e' || *str == 'E') && allowExponent) {
+
+				bool negExp = false;
+
+				if (++str != end && (*str == '-' || *str == '+'))
+					negExp = *str++ == '-';
+
+				if (str == end)
+					return false;
+
+				for (; str != end && *str >= '0' && *str <= '9'; ++str)
+					if (exp < 100000)
+						exp = exp * 10 + (*str - '0');
+
+				if (negExp)
+					exp = -exp;
+			}
+
+			if (str != end)
+				return false;
+
+			f64 val = 0;
+
+			//Value is in [10^(magnitude - 1), 10^magnitude)
+			i64 magnitude = decimalPosition + exp;
+
+			if (count != 0 && magnitude > 310)
+				return false;
+
+			if (count != 0 && magnitude >= -330) {
+
+				val = toDouble(digits, count, (i32)(decimalPosition - (i64) count + exp));
+
+				if (val == std::numeric_limits<f64>::infinity())
+					return false;
+			}
+
+			res = neg ? -val : val;
+			return true;
+		}
+
+		static bool parse(const char *str, u32 len, f32 &res, bool allowExponent = true) {
+
+			f64 val;
+
+			if (!parse(str, len, val, allowExponent) || std::abs(val) > std::numeric_limits<f32>::max())
+				return false;
+
+			res = (f32) val;
+			return true;
+		}
+
+	private:
+
+		//Writes nan, inf and (-)0; returns nullptr if it isn't one of those
+		template<typename T>
+		static char *formatSpecial(T f, char *buffer) {
+
+			if (f != f) {
+				memcpy(buffer, "nan", 3);
+				return buffer + 3;
+			}
+
+			if (f == 0 || std::abs(f) == std::numeric_limits<T>::infinity()) {
+
+				if (std::signbit(f))
+					*buffer++ = '-';
+
+				if (f == 0) {
+					*buffer = '0';
+					return buffer + 1;
+				}
+
+				memcpy(buffer, "inf", 3);
+				return buffer + 3;
+			}
+
+			return nullptr;
+		}
+
+		//digits * 10^k written as a decimal or in e notation; without trailing ".0"
+		static char *prettify(char *buffer, int length, int k) {
+
+			char *end = rapidjson::internal::Prettify(buffer, length, k, 324);
+
+			if (end - buffer >= 2 && end[-2] == '.' && end[-1] == '0')
+				end -= 2;
+
+			return end;
+		}
+
+		//Correctly rounded decimals * 10^exp
+		static f64 toDouble(const char *decimals, u32 length, i32 exp) {
+
+			u64 significand = 0;
+
+			for (u32 i = 0; i < length && i < 19; ++i)
+				significand = significand * 10 + (u64)(decimals[i] - '0');
+
+			//Above 19 digits the significand isn't exact; it's large enough that the fast path isn't taken
+			i32 p = length > 19 ? exp + (i32) length - 19 : exp;
+
+			return rapidjson::internal::StrtodFullPrecision((f64) significand, p, decimals, length, length, exp);
+		}
+
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,349 @@
+#pragma once
+
+#include "types/generic.h"
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+//SSE is available on every x64 target; USE_SCALAR forces the scalar kernels
+#if !defined(USE_SCALAR) && (defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+	#define __SIMD_SSE__
+	#include <xmmintrin.h>
+#endif
+
+//AVX is only used by the batched kernels (types/batch.h); it has to be enabled by the compiler (/arch:AVX or -mavx)
+#if defined(__SIMD_SSE__) && defined(__AVX__)
+	#define __SIMD_AVX__
+	#include <immintrin.h>
+#endif
+
+//NEON is available on every AArch64 target; the kernels use AArch64 only instructions (vdivq_f32, vaddvq_f32)
+#if !defined(USE_SCALAR) && !defined(__SIMD_SSE__) && (defined(__aarch64__) || defined(_M_ARM64))
+	#define __SIMD_NEON__
+	#include <arm_neon.h>
+#endif
+
+namespace oi {
+
+	//Kernels for TVec; operate on the raw array of n elements
+	template<typename T, u32 n>
+	struct VecOps {
+
+		static void add(T *a, const T *b) { for (u32 i = 0; i < n; ++i) a[i] += b[i]; }
+		static void sub(T *a, const T *b) { for (u32 i = 0; i < n; ++i) a[i] -= b[i]; }
+		static void mul(T *a, const T *b) { for (u32 i = 0; i < n; ++i) a[i] *= b[i]; }
+		static void div(T *a, const T *b) { for (u32 i = 0; i < n; ++i) a[i] /= b[i]; }
+
+		static T dot(const T *a, const T *b) {
+
+			T res = 0;
+
+			for (u32 i = 0; i < n; ++i)
+				res += a[i] * b[i];
+
+			return res;
+		}
+
+	};
+
+	//Kernels for TMatrix; column major (m[column][row]) raw arrays
+	template<typename T, u32 w, u32 h>
+	struct MatrixOps {
+
+		//res = a * b (square matrices); res can't alias a or b
+		static void mul(const T *a, const T *b, T *res) {
+
+			static_assert(w == h, "MatrixOps::mul is only available for square matrices");
+
+			for (u32 i = 0; i < w; ++i)
+				for (u32 j = 0; j < h; ++j) {
+
+					T sum = 0;
+
+					for (u32 k = 0; k < w; ++k)
+						sum += a[k * h + j] * b[i * h + k];
+
+					res[i * h + j] = sum;
+				}
+		}
+
+		//res = a * v; v has w elements, res has h elements
+		static void mulVec(const T *a, const T *v, T *res) {
+
+			for (u32 j = 0; j < h; ++j)
+				res[j] = 0;
+
+			for (u32 i = 0; i < w; ++i)
+				for (u32 j = 0; j < h; ++j)
+					res[j] += a[i * h + j] * v[i];
+		}
+
+		//res (h x w) = transpose(a)
+		static void transpose(const T *a, T *res) {
+			for (u32 i = 0; i < w; ++i)
+				for (u32 j = 0; j < h; ++j)
+					res[j * w + i] = a[i * h + j];
+		}
+
+		//Gauss-Jordan elimination with partial pivoting; returns false if it's singular
+		static bool inverse(const T *a, T *res) {
+
+			static_assert(w == h && std::is_floating_point<T>::value, "MatrixOps::inverse is only available for square floating point matrices");
+
+			T tmp[w * h];
+
+			for (u32 i = 0; i < w * h; ++i) {
+				tmp[i] = a[i];
+				res[i] = i / h == i % h ? (T) 1 : (T) 0;
+			}
+
+			for (u32 c = 0; c < w; ++c) {
+
+				u32 pivot = c;
+
+				for (u32 r = c + 1; r < h; ++r)
+					if (std::abs(tmp[c * h + r]) > std::abs(tmp[c * h + pivot]))
+						pivot = r;
+
+				if (tmp[c * h + pivot] == 0)
+					return false;
+
+				if (pivot != c)
+					for (u32 i = 0; i < w; ++i) {
+						std::swap(tmp[i * h + c], tmp[i * h + pivot]);
+						std::swap(res[i * h + c], res[i * h + pivot]);
+					}
+
+				T scale = (T) 1 / tmp[c * h + c];
+
+				for (u32 i = 0; i < w; ++i) {
+					tmp[i * h + c] *= scale;
+					res[i * h + c] *= scale;
+				}
+
+				for (u32 r = 0; r < h; ++r) {
+
+					if (r == c) continue;
+
+					T factor = tmp[c * h + r];
+
+					for (u32 i = 0; i < w; ++i) {
+						tmp[i * h + r] -= factor * tmp[i * h + c];
+						res[i * h + r] -= factor * res[i * h + c];
+					}
+				}
+			}
+
+			return true;
+		}
+
+	};
+
+	//4x4 inverse through 2x2 sub determinants (cofactors); doesn't branch, so it vectorizes well
+	template<>
+	inline bool MatrixOps<f32, 4, 4>::inverse(const f32 *m, f32 *res) {
+
+		f32 s0 = m[0] * m[5] - m[4] * m[1];
+		f32 s1 = m[0] * m[6] - m[4] * m[2];
+		f32 s2 = m[0] * m[7] - m[4] * m[3];
+		f32 s3 = m[1] * m[6] - m[5] * m[2];
+		f32 s4 = m[1] * m[7] - m[5] * m[3];
+		f32 s5 = m[2] * m[7] - m[6] * m[3];
+
+		f32 c5 = m[10] * m[15] - m[14] * m[11];
+		f32 c4 = m[9] * m[15] - m[13] * m[11];
+		f32 c3 = m[9] * m[14] - m[13] * m[10];
+		f32 c2 = m[8] * m[15] - m[12] * m[11];
+		f32 c1 = m[8] * m[14] - m[12] * m[10];
+		f32 c0 = m[8] * m[13] - m[12] * m[9];
+
+		f32 det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+
+		if (det == 0)
+			return false;
+
+		f32 inv = 1 / det;
+
+		res[0] = (m[5] * c5 - m[6] * c4 + m[7] * c3) * inv;
+		res[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * inv;
+		res[2] = (m[13] * s5 - m[14] * s4 + m[15] * s3) * inv;
+		res[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * inv;
+
+		res[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * inv;
+		res[5] = (m[0] * c5 - m[2] * c2 + m[3] * c1) * inv;
+		res[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * inv;
+		res[7] = (m[8] * s5 - m[10] * s2 + m[11] * s1) * inv;
+
+		res[8] = (m[4] * c4 - m[5] * c2 + m[7] * c0) * inv;
+		res[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * inv;
+		res[10] = (m[12] * s4 - m[13] * s2 + m[15] * s0) * inv;
+		res[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * inv;
+
+		res[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * inv;
+		res[13] = (m[0] * c3 - m[1] * c1 + m[2] * c0) * inv;
+		res[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * inv;
+		res[15] = (m[8] * s3 - m[9] * s1 + m[10] * s0) * inv;
+
+		return true;
+	}
+
+	//Copies count elements into dst, where they are stride bytes apart (stride >= sizeof(T)); for arrays in std140/std430 buffers
+	//The element size is a constant, so every element is a few moves instead of a memcpy call
+	//Elements smaller than 16 bytes (with a stride of at least 16) are copied with one 16 byte move; so the padding after them is overwritten
+	template<typename T>
+	struct StridedOps {
+
+		static void copy(u8 *dst, const T *src, u32 count, u32 stride) {
+
+			static_assert(std::is_standard_layout<T>::value && std::is_trivially_destructible<T>::value, "StridedOps requires plain data");
+
+			u32 i = 0;
+
+		#if defined(__SIMD_SSE__) || defined(__SIMD_NEON__)
+
+			//The 16 byte load reads past the element; so the last elements (that would read past src + count) are copied normally
+			constexpr u32 overread = (16 + (u32) sizeof(T) - 1) / (u32) sizeof(T) - 1;
+
+			if (sizeof(T) < 16 && stride >= 16 && count > overread)
+				for (const u8 *ptr = (const u8*) src; i < count - overread; ++i, ptr += sizeof(T))
+
+				#ifdef __SIMD_SSE__
+					_mm_storeu_ps((f32*)(dst + (size_t) i * stride), _mm_loadu_ps((const f32*) ptr));
+				#else
+					vst1q_u8(dst + (size_t) i * stride, vld1q_u8(ptr));
+				#endif
+
+		#endif
+
+			for (; i < count; ++i)
+				memcpy(dst + (size_t) i * stride, src + i, sizeof(T));
+		}
+
+	};
+
+	#ifdef __SIMD_SSE__
+
+	template<>
+	struct VecOps<f32, 4> {
+
+		static void add(f32 *a, const f32 *b) { _mm_storeu_ps(a, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b))); }
+		static void sub(f32 *a, const f32 *b) { _mm_storeu_ps(a, _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b))); }
+		static void mul(f32 *a, const f32 *b) { _mm_storeu_ps(a, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b))); }
+		static void div(f32 *a, const f32 *b) { _mm_storeu_ps(a, _mm_div_ps(_mm_loadu_ps(a), _mm_loadu_ps(b))); }
+
+		static f32 dot(const f32 *a, const f32 *b) {
+
+			__m128 m = _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+			m = _mm_add_ps(m, _mm_movehl_ps(m, m));							//x + z, y + w
+			m = _mm_add_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1)));	//+ y + w
+
+			return _mm_cvtss_f32(m);
+		}
+
+	};
+
+	template<>
+	inline void MatrixOps<f32, 4, 4>::mul(const f32 *a, const f32 *b, f32 *res) {
+
+		__m128 c0 = _mm_loadu_ps(a), c1 = _mm_loadu_ps(a + 4), c2 = _mm_loadu_ps(a + 8), c3 = _mm_loadu_ps(a + 12);
+
+		//Column i of the result is a linear combination of the columns of a
+		for (u32 i = 0; i < 4; ++i) {
+
+			const f32 *col = b + i * 4;
+
+			__m128 r = _mm_mul_ps(c0, _mm_set1_ps(col[0]));
+			r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_set1_ps(col[1])));
+			r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(col[2])));
+			r = _mm_add_ps(r, _mm_mul_ps(c3, _mm_set1_ps(col[3])));
+
+			_mm_storeu_ps(res + i * 4, r);
+		}
+	}
+
+	template<>
+	inline void MatrixOps<f32, 4, 4>::mulVec(const f32 *a, const f32 *v, f32 *res) {
+
+		__m128 r = _mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(v[0]));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a + 4), _mm_set1_ps(v[1])));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a + 8), _mm_set1_ps(v[2])));
+		r = _mm_add_ps(r, _mm_mul_ps(_mm_loadu_ps(a + 12), _mm_set1_ps(v[3])));
+
+		_mm_storeu_ps(res, r);
+	}
+
+	template<>
+	inline void MatrixOps<f32, 4, 4>::transpose(const f32 *a, f32 *res) {
+
+		__m128 c0 = _mm_loadu_ps(a), c1 = _mm_loadu_ps(a + 4), c2 = _mm_loadu_ps(a + 8), c3 = _mm_loadu_ps(a + 12);
+
+		_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+		_mm_storeu_ps(res, c0);
+		_mm_storeu_ps(res + 4, c1);
+		_mm_storeu_ps(res + 8, c2);
+		_mm_storeu_ps(res + 12, c3);
+	}
+
+	#endif
+
+	#ifdef __SIMD_NEON__
+
+	template<>
+	struct VecOps<f32, 4> {
+
+		static void add(f32 *a, const f32 *b) { vst1q_f32(a, vaddq_f32(vld1q_f32(a), vld1q_f32(b))); }
+		static void sub(f32 *a, const f32 *b) { vst1q_f32(a, vsubq_f32(vld1q_f32(a), vld1q_f32(b))); }
+		static void mul(f32 *a, const f32 *b) { vst1q_f32(a, vmulq_f32(vld1q_f32(a), vld1q_f32(b))); }
+		static void div(f32 *a, const f32 *b) { vst1q_f32(a, vdivq_f32(vld1q_f32(a), vld1q_f32(b))); }
+
+		static f32 dot(const f32 *a, const f32 *b) { return vaddvq_f32(vmulq_f32(vld1q_f32(a), vld1q_f32(b))); }
+
+	};
+
+	template<>
+	inline void MatrixOps<f32, 4, 4>::mul(const f32 *a, const f32 *b, f32 *res) {
+
+		float32x4_t c0 = vld1q_f32(a), c1 = vld1q_f32(a + 4), c2 = vld1q_f32(a + 8), c3 = vld1q_f32(a + 12);
+
+		//Column i of the result is a linear combination of the columns of a
+		for (u32 i = 0; i < 4; ++i) {
+
+			const f32 *col = b + i * 4;
+
+			float32x4_t r = vmulq_n_f32(c0, col[0]);
+			r = vmlaq_n_f32(r, c1, col[1]);
+			r = vmlaq_n_f32(r, c2, col[2]);
+			r = vmlaq_n_f32(r, c3, col[3]);
+
+			vst1q_f32(res + i * 4, r);
+		}
+	}
+
+	template<>
+	inline void MatrixOps<f32, 4, 4>::mulVec(const f32 *a, const f32 *v, f32 *res) {
+
+		float32x4_t r = vmulq_n_f32(vld1q_f32(a), v[0]);
+		r = vmlaq_n_f32(r, vld1q_f32(a + 4), v[1]);
+		r = vmlaq_n_f32(r, vld1q_f32(a + 8), v[2]);
+		r = vmlaq_n_f32(r, vld1q_f32(a + 12), v[3]);
+
+		vst1q_f32(res, r);
+	}
+
+	template<>
+	inline void MatrixOps<f32, 4, 4>::transpose(const f32 *a, f32 *res) {
+
+		//De-interleaving load; val[i] is every 4th element starting at i, which is row i
+		float32x4x4_t rows = vld4q_f32(a);
+
+		vst1q_f32(res, rows.val[0]);
+		vst1q_f32(res + 4, rows.val[1]);
+		vst1q_f32(res + 8, rows.val[2]);
+		vst1q_f32(res + 12, rows.val[3]);
+	}
+
+	#endif
+
+}
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "generic.h"
+#include "number.h"
 #include <sstream>
+#include <string_view>
+#include <cctype>
 
 namespace oi {
 
@@ -9,15 +12,186 @@ namespace oi {
 
 	class JSON;
 	class Buffer;
+	class String;
+	class StringSplit;
+
+	//Non-owning view into a string; only valid as long as the string it refers to isn't modified or destroyed
+	//Mirrors the read-only part of String, but never allocates
+	class StringRef {
+
+	public:
+
+		StringRef() {}
+		StringRef(const char *source) : view(source) {}
+		StringRef(const char *source, u32 len) : view(source, len) {}
+		StringRef(std::string_view source) : view(source) {}
+		StringRef(const std::string &source) : view(source) {}
+		StringRef(const String &str);
+
+		u32 size() const { return (u32) view.size(); }
+		bool empty() const { return view.empty(); }
+		const char *data() const { return view.data(); }
+
+		char operator[](u32 i) const { return view[i]; }
+		char at(u32 i) const { return i < size() ? view[i] : '\0'; }
+
+		auto begin() const { return view.begin(); }
+		auto end() const { return view.end(); }
+
+		StringRef cutBegin(u32 start) const { return start >= size() ? StringRef() : StringRef(view.substr(start)); }
+		StringRef cutEnd(u32 end) const { return StringRef(view.substr(0, end)); }
+		StringRef substring(u32 start, u32 end) const { return start >= end || start >= size() ? StringRef() : StringRef(view.substr(start, end - start)); }
+
+		//Returns u32_MAX if it isn't found
+		u32 findFirst(char c, u32 start = 0) const { return toIndex(view.find(c, start)); }
+		u32 findFirst(StringRef s, u32 start = 0) const { return toIndex(view.find(s.view, start)); }
+		u32 findLast(char c) const { return toIndex(view.rfind(c)); }
+		u32 findLast(StringRef s) const { return toIndex(view.rfind(s.view)); }
+
+		bool contains(StringRef s) const { return view.find(s.view) != std::string_view::npos; }
+		bool startsWith(StringRef s) const { return view.substr(0, s.size()) == s.view; }
+		bool endsWith(StringRef s) const { return s.size() <= size() && view.substr(size() - s.size()) == s.view; }
+
+		bool equalsIgnoreCase(StringRef s) const {
+
+			if (s.size() != size())
+				return false;
+
+			for (u32 i = 0; i < size(); ++i)
+				if (tolower((u8) view[i]) != tolower((u8) s.view[i]))
+					return false;
+
+			return true;
+		}
+
+		//Removes whitespace at the start and end
+		StringRef trim() const {
+
+			u32 start = 0, end = size();
+
+			while (start < end && isspace((u8) view[start])) ++start;
+			while (end > start && isspace((u8) view[end - 1])) --end;
+
+			return substring(start, end);
+		}
+
+		//Splits by separator; empty parts are kept, so "a__b" is "a", "", "b"
+		StringSplit split(StringRef separator) const;
+
+		//Parse and validate in one go; return false (and leave res untouched) if it isn't a number that fits
+
+		bool toUint(u32 &res) const { return Number::parse(data(), size(), res); }
+		bool toUint(u64 &res) const { return Number::parse(data(), size(), res); }
+		bool toLong(i64 &res) const { return Number::parse(data(), size(), res); }
+		bool toFloat(f32 &res) const { return Number::parse(data(), size(), res); }
+		bool toDouble(f64 &res) const { return Number::parse(data(), size(), res); }
+
+		bool isUint() const { u64 res; return toUint(res); }
+		bool isInt() const { i64 res; return toLong(res); }
+		bool isFloat() const { f64 res; return toDouble(res); }
+
+		//Returns 0 if it isn't an integer
+		i64 toLong() const {
+			i64 res = 0;
+			toLong(res);
+			return res;
+		}
+
+		bool operator==(StringRef other) const { return view == other.view; }
+		bool operator!=(StringRef other) const { return view != other.view; }
+		bool operator<(StringRef other) const { return view < other.view; }
+
+		operator std::string_view() const { return view; }
+		std::string_view toStdView() const { return view; }
+
+	private:
+
+		static u32 toIndex(size_t i) { return i == std::string_view::npos ? u32_MAX : (u32) i; }
+
+		std::string_view view;
+
+	};
+
+	//Lazily splits a string; for (StringRef part : str.split("_"))
+	class StringSplit {
+
+	public:
+
+		class Iterator {
+
+		public:
+
+			Iterator(StringRef source, StringRef separator, u32 start) : source(source), separator(separator), start(start) { next(); }
+
+			StringRef operator*() const { return source.substring(start, end); }
+
+			Iterator &operator++() {
+
+				if (end >= source.size())
+					start = u32_MAX;
+				else {
+					start = end + separator.size();
+					next();
+				}
+
+				return *this;
+			}
+
+			bool operator==(const Iterator &other) const { return start == other.start; }
+			bool operator!=(const Iterator &other) const { return start != other.start; }
+
+		private:
+
+			void next() {
+
+				if (start == u32_MAX)
+					return;
+
+				end = separator.empty() ? u32_MAX : source.findFirst(separator, start);
+
+				if (end == u32_MAX)
+					end = source.size();
+			}
+
+			StringRef source, separator;
+			u32 start, end = 0;
+
+		};
+
+		StringSplit(StringRef source, StringRef separator) : source(source), separator(separator) {}
+
+		Iterator begin() const { return Iterator(source, separator, 0); }
+		Iterator end() const { return Iterator(source, separator, u32_MAX); }
+
+		//Returns the number of parts
+		u32 size() const {
+
+			u32 i = 0;
+
+			for (auto it = begin(); it != end(); ++it)
+				++i;
+
+			return i;
+		}
+
+	private:
+
+		StringRef source, separator;
+
+	};
+
+	inline StringSplit StringRef::split(StringRef separator) const { return StringSplit(*this, separator); }
 
 	class String {
 
 		friend struct std::hash<String>;
+		friend class StringRef;
 
 	public:
 
 		String();
 		String(std::string source);
+		String(std::string_view source) : String(std::string(source)) {}
 		String(const char *source);
 		String(char *source, u32 len);
 		String(u32 len, char filler);
@@ -75,8 +249,17 @@ namespace oi {
 			return ss.str();
 		}
 
+		//Shortest text that parses back to the same number; doesn't depend on the locale (types/number.h)
+		template<class T>
+		static String formatNumber(T t);
+
 		i64 toLong() const;
 		flp toFloat() const;
+
+		//Parse and validate in one go; return false (and leave res untouched) if it isn't a number that fits (types/number.h)
+		bool parseUint(u64 &res) const { return ref().toUint(res); }
+		bool parseLong(i64 &res) const { return ref().toLong(res); }
+		bool parseFloat(flp &res) const { return Number::parse(source.data(), (u32) source.size(), res); }
 		std::string toStdString() const;
 		const char *toCString() const;
 
@@ -120,17 +303,132 @@ namespace oi {
 		auto begin() const { return source.begin(); }
 		auto end() const { return source.end(); }
 
-		static String decode(Buffer buf, String charset, u8 perChar);	//Decode the buffer given; perChar is in bits; so you could use decode(buf, { '0', '1' }, 1) to turn it into a binary string (Would not recommend; is slow)
+		static String decode(Buffer buf, String charset, u8 perChar);	//Decode the buffer given; perChar is in bits; so you could use decode(buf, { '0', '1' }, 1) to turn it into a binary string (Would not recommend; is slow; see StringPacking)
 		static String decode(Buffer buf, String charset, u8 perChar, u32 length);
 		Buffer encode(String charset, u8 perChar) const;				//Encode the String given; allocates a new buffer, make sure to deconstruct it.
 
 		static String getDefaultCharset();
 
+		//Non-allocating variants
+
+		StringRef ref() const { return source; }
+
+		StringSplit splitRef(StringRef separator) const { return StringSplit(source, separator); }		//Only valid as long as this string isn't modified
+
+		//Replaces all occurrences; only reallocates if the result doesn't fit the capacity
+		String &replaceInPlace(StringRef s0, StringRef s1) {
+
+			if (s0.empty())
+				return *this;
+
+			for (size_t i = source.find(s0); i != std::string::npos; i = source.find(s0, i + s1.size()))
+				source.replace(i, s0.size(), s1);
+
+			return *this;
+		}
+
+		String &trimInPlace() {
+
+			size_t end = source.size();
+
+			while (end > 0 && isspace((u8) source[end - 1])) --end;
+			source.erase(end);
+
+			size_t start = 0;
+
+			while (start < end && isspace((u8) source[start])) ++start;
+			source.erase(0, start);
+
+			return *this;
+		}
+
+		String &toLowerCaseInPlace() {
+			for (char &c : source) c = (char) tolower((u8) c);
+			return *this;
+		}
+
+		String &toUpperCaseInPlace() {
+			for (char &c : source) c = (char) toupper((u8) c);
+			return *this;
+		}
+
+		//Appends into one growing buffer; build() hands it over to a String without copying
+		class Builder {
+
+		public:
+
+			Builder(u32 reserve = 0) { buf.reserve(reserve); }
+
+			Builder &operator+=(StringRef s) { buf.append(s.data(), s.size()); return *this; }
+			Builder &operator+=(const String &s) { buf += s.source; return *this; }
+			Builder &operator+=(const std::string &s) { buf += s; return *this; }
+			Builder &operator+=(const char *s) { buf += s; return *this; }
+			Builder &operator+=(char c) { buf += c; return *this; }
+
+			Builder &operator+=(i32 i) { return appendNumber(i); }
+			Builder &operator+=(u32 u) { return appendNumber(u); }
+			Builder &operator+=(i64 i) { return appendNumber(i); }
+			Builder &operator+=(u64 u) { return appendNumber(u); }
+
+			Builder &operator+=(f32 f) { return appendNumber(f); }
+			Builder &operator+=(f64 f) { return appendNumber(f); }
+
+			template<typename T>
+			Builder &operator<<(const T &t) { return *this += t; }
+
+			u32 size() const { return (u32) buf.size(); }
+			StringRef ref() const { return buf; }
+			void clear() { buf.clear(); }
+			void reserve(u32 size) { buf.reserve(size); }
+
+			//Leaves the builder empty
+			String build() {
+				String res;
+				res.source.swap(buf);
+				return res;
+			}
+
+		private:
+
+			template<typename T>
+			Builder &appendNumber(T t) {
+				char tmp[Number::maxChars];
+				buf.append(tmp, Number::format(t, tmp));
+				return *this;
+			}
+
+			std::string buf;
+
+		};
+
 	protected:
 
 		std::string source;
+
 	};
 
+	template<class T>
+	String String::formatNumber(T t) {
+
+		static_assert(std::is_arithmetic<T>::value, "T is not a number");
+
+		char tmp[Number::maxChars];
+		char *end;
+
+		if constexpr (std::is_floating_point<T>::value)
+			end = Number::format(typename std::conditional<sizeof(T) == 4, f32, f64>::type(t), tmp);
+		else if constexpr (std::is_signed<T>::value)
+			end = Number::format(typename std::conditional<sizeof(T) <= 4, i32, i64>::type(t), tmp);
+		else
+			end = Number::format(typename std::conditional<sizeof(T) <= 4, u32, u64>::type(t), tmp);
+
+		String res;
+		res.source.assign(tmp, end);
+		return res;
+	}
+
+	inline StringRef::StringRef(const String &str) : view(str.source) {}
+
 }
 
 //Hashing for String
@@ -141,4 +439,11 @@ namespace std {
 			return hash<std::string>()(str.source);
 		}
 	};
+
+	template<>
+	struct hash<oi::StringRef> {
+		inline size_t operator()(oi::StringRef str) const {
+			return hash<std::string_view>()(str.toStdView());
+		}
+	};
 }
\ No newline at end of file
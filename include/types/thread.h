@@ -1,11 +1,509 @@
 #pragma once
 
-#include "Generic.h"
-#include <future>
+#include "generic.h"
 #include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <exception>
 
 namespace oi {
 
+	class TaskScheduler;
+
+	//The first exception thrown by a group of tasks (TaskScheduler::run, parallelFor); it's rethrown once the group is done
+	struct TaskError {
+
+		std::atomic<bool> thrown = { false };
+		std::exception_ptr error;
+
+		void set(std::exception_ptr e) {
+			if (!thrown.exchange(true, std::memory_order_acq_rel))
+				error = e;
+		}
+
+		//Only after all tasks of the group are done
+		void rethrow() {
+			if (error)
+				std::rethrow_exception(error);
+		}
+
+	};
+
+	//A unit of work; run is called once all tasks before it are done
+	//Tasks aren't owned by the scheduler, so they have to stay alive until they're finished
+	//run can't throw; FunctionTask and RangeTask catch and store exceptions into 'error' (a task submitted on its own has none, so it has to handle them)
+	struct Task {
+
+		void (*run)(Task*) = nullptr;
+
+		std::vector<Task*> successors;						//Tasks that wait for this one
+		u32 predecessors = 0;								//Tasks this one waits for
+
+		std::atomic<u32> dependencies = { 0 };				//Predecessors that aren't done yet
+		std::atomic<u32> *counter = nullptr;				//Decremented when the task is done
+		TaskError *error = nullptr;
+
+
+		virtual ~Task() {}
+
+		//Called from a catch block
+		void fail() {
+
+			if (error == nullptr)
+				std::terminate();
+
+			error->set(std::current_exception());
+		}
+
+		//b can only run after a is done
+		static void precede(Task *a, Task *b) {
+			a->successors.push_back(b);
+			++b->predecessors;
+		}
+
+	};
+
+	template<typename F>
+	struct FunctionTask : public Task {
+
+		F f;
+
+		FunctionTask(F f) : f(std::move(f)) {
+			run = [](Task *t) {
+				try { ((FunctionTask*) t)->f(); }
+				catch (...) { t->fail(); }
+			};
+		}
+
+	};
+
+	//Chase-Lev work stealing deque; the owning thread pushes and pops at the bottom, other threads steal from the top
+	class TaskDeque {
+
+	public:
+
+		TaskDeque(u32 capacity = 256) { arrays.emplace_back(new Array(capacity)); array.store(arrays.back().get(), std::memory_order_relaxed); }
+
+		//Owner only
+		void push(Task *task) {
+
+			i64 b = bottom.load(std::memory_order_relaxed), t = top.load(std::memory_order_acquire);
+			Array *a = array.load(std::memory_order_relaxed);
+
+			if (b - t > (i64) a->mask)
+				a = grow(a, t, b);
+
+			a->put(b, task);
+			std::atomic_thread_fence(std::memory_order_release);
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+
+		//Owner only; returns nullptr if it's empty
+		Task *pop() {
+
+			i64 b = bottom.load(std::memory_order_relaxed) - 1;
+			Array *a = array.load(std::memory_order_relaxed);
+
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			i64 t = top.load(std::memory_order_relaxed);
+
+			if (t > b) {
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Task *task = a->get(b);
+
+			//Last one; race against the thieves
+			if (t == b) {
+
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					task = nullptr;
+
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+
+			return task;
+		}
+
+		//Any thread; returns nullptr if it's empty or another thread got there first
+		Task *steal() {
+
+			i64 t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			i64 b = bottom.load(std::memory_order_acquire);
+
+			if (t >= b)
+				return nullptr;
+
+			Task *task = array.load(std::memory_order_acquire)->get(t);
+
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+
+			return task;
+		}
+
+	private:
+
+		struct Array {
+
+			u64 mask;
+			std::unique_ptr<std::atomic<Task*>[]> tasks;
+
+			Array(u64 capacity) : mask(capacity - 1), tasks(new std::atomic<Task*>[capacity]) {}
+
+			Task *get(i64 i) const { return tasks[(u64) i & mask].load(std::memory_order_acquire); }
+			void put(i64 i, Task *task) { tasks[(u64) i & mask].store(task, std::memory_order_release); }
+
+		};
+
+		//Old arrays are kept, since thieves can still be reading them
+		Array *grow(Array *a, i64 t, i64 b) {
+
+			arrays.emplace_back(new Array((a->mask + 1) * 2));
+			Array *next = arrays.back().get();
+
+			for (i64 i = t; i < b; ++i)
+				next->put(i, a->get(i));
+
+			array.store(next, std::memory_order_release);
+			return next;
+		}
+
+		alignas(64) std::atomic<i64> top = { 0 };
+		alignas(64) std::atomic<i64> bottom = { 0 };
+		std::atomic<Array*> array;
+
+		std::vector<std::unique_ptr<Array>> arrays;
+
+	};
+
+	//Persistent worker threads (one per core besides the calling thread) that take work from each other
+	//Tasks submitted by a worker go to its own deque; other threads submit through a shared queue
+	//Waiting executes tasks instead of blocking, so tasks can submit and wait for more tasks
+	class TaskScheduler {
+
+	public:
+
+		TaskScheduler(u32 workers) : queues(workers) {
+
+			for (u32 i = 0; i < workers; ++i)
+				threads.emplace_back([this, i]() { work(i); });
+		}
+
+		~TaskScheduler() {
+
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex);
+				stop = true;
+			}
+
+			sleepCondition.notify_all();
+
+			for (std::thread &t : threads)
+				t.join();
+		}
+
+		TaskScheduler(const TaskScheduler&) = delete;
+		TaskScheduler &operator=(const TaskScheduler&) = delete;
+
+		//The global scheduler; started on first use
+		static TaskScheduler &get() {
+			static TaskScheduler scheduler(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1);
+			return scheduler;
+		}
+
+		u32 getWorkers() const { return (u32) threads.size(); }
+
+		//Runs the task once its dependencies are 0
+		void submit(Task *task) { submit(&task, 1); }
+
+		void submit(Task **tasks, u32 count) {
+
+			if (count == 0)
+				return;
+
+			u32 worker = getWorker();
+
+			if (worker != u32_MAX)
+				for (u32 i = 0; i < count; ++i)
+					queues[worker].push(tasks[i]);
+			else {
+				std::lock_guard<std::mutex> lock(sharedMutex);
+				shared.insert(shared.end(), tasks, tasks + count);
+				sharedSize.store((u32) shared.size(), std::memory_order_relaxed);
+			}
+
+			queued.fetch_add(count);
+
+			if (sleeping.load() != 0) {
+				std::lock_guard<std::mutex> lock(sleepMutex);
+
+				if (count == 1)
+					sleepCondition.notify_one();
+				else
+					sleepCondition.notify_all();
+			}
+		}
+
+		//Executes tasks until the counter is 0
+		void wait(const std::atomic<u32> &counter) {
+
+			u32 worker = getWorker();
+
+			while (counter.load(std::memory_order_acquire) != 0) {
+
+				if (Task *task = find(worker))
+					execute(task);
+				else
+					std::this_thread::yield();
+			}
+		}
+
+		//Runs the tasks in the graph order and waits for them; see TaskGraph
+		//If a task throws, the tasks that didn't start yet are skipped and the first exception is rethrown once all are done
+		void run(Task **tasks, u32 count) {
+
+			std::atomic<u32> counter = { count };
+			TaskError error;
+			std::vector<Task*> roots;
+
+			for (u32 i = 0; i < count; ++i) {
+
+				tasks[i]->counter = &counter;
+				tasks[i]->error = &error;
+				tasks[i]->dependencies.store(tasks[i]->predecessors, std::memory_order_relaxed);
+
+				if (tasks[i]->predecessors == 0)
+					roots.push_back(tasks[i]);
+			}
+
+			submit(roots.data(), (u32) roots.size());
+			wait(counter);
+			error.rethrow();
+		}
+
+		//f(u32 i) for i in [begin, end); grain is the number of iterations per task (0 = pick one based on the number of threads)
+		//If f throws, the chunks that didn't start yet are skipped and the first exception is rethrown once all chunks are done
+		template<typename F>
+		void parallelFor(u32 begin, u32 end, F f, u32 grain = 0) {
+
+			if (end <= begin)
+				return;
+
+			u32 count = end - begin;
+
+			//A few tasks per thread, so threads that finish early can steal the rest
+			if (grain == 0)
+				grain = count / ((getWorkers() + 1) * 4);
+
+			if (grain == 0)
+				grain = 1;
+
+			u32 chunks = (count + grain - 1) / grain;
+
+			if (chunks == 1) {
+
+				for (u32 i = begin; i < end; ++i)
+					f(i);
+
+				return;
+			}
+
+			auto range = [&f](u32 start, u32 stop) {
+				for (u32 i = start; i < stop; ++i)
+					f(i);
+			};
+
+			typedef RangeTask<decltype(range)> Chunk;
+
+			std::vector<Chunk> tasks;
+			tasks.reserve(chunks);
+
+			std::vector<Task*> ptrs(chunks);
+			std::atomic<u32> counter = { chunks };
+			TaskError error;
+
+			for (u32 i = 0; i < chunks; ++i) {
+
+				u32 start = begin + i * grain;
+				tasks.emplace_back(range, start, count - i * grain < grain ? end : start + grain);
+
+				tasks[i].counter = &counter;
+				tasks[i].error = &error;
+				ptrs[i] = &tasks[i];
+			}
+
+			//The calling thread takes the first chunk itself; it doesn't throw, so the queued chunks can't outlive the range and counter
+			submit(ptrs.data() + 1, chunks - 1);
+			execute(ptrs[0]);
+			wait(counter);
+			error.rethrow();
+		}
+
+	private:
+
+		template<typename F>
+		struct RangeTask : public Task {
+
+			F &f;
+			u32 start, stop;
+
+			RangeTask(F &f, u32 start, u32 stop) : f(f), start(start), stop(stop) {
+				run = [](Task *t) {
+					RangeTask *r = (RangeTask*) t;
+					try { r->f(r->start, r->stop); }
+					catch (...) { r->fail(); }
+				};
+			}
+			RangeTask(RangeTask &&other) : RangeTask(other.f, other.start, other.stop) {}
+
+		};
+
+		struct WorkerId {
+			TaskScheduler *scheduler;
+			u32 index;
+		};
+
+		static WorkerId &getWorkerId() {
+			thread_local WorkerId id = { nullptr, 0 };
+			return id;
+		}
+
+		//Returns u32_MAX if the calling thread isn't a worker of this scheduler
+		u32 getWorker() {
+			WorkerId &id = getWorkerId();
+			return id.scheduler == this ? id.index : u32_MAX;
+		}
+
+		void execute(Task *task) {
+
+			//Skip the rest of a group that failed
+			if (task->error == nullptr || !task->error->thrown.load(std::memory_order_relaxed))
+				task->run(task);
+
+			for (Task *next : task->successors)
+				if (next->dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					submit(next);
+
+			if (task->counter != nullptr)
+				task->counter->fetch_sub(1, std::memory_order_release);
+		}
+
+		//Own deque, then the shared queue, then the other workers
+		Task *find(u32 worker) {
+
+			Task *task = nullptr;
+
+			if (worker != u32_MAX)
+				task = queues[worker].pop();
+
+			if (task == nullptr && sharedSize.load(std::memory_order_relaxed) != 0) {
+
+				std::lock_guard<std::mutex> lock(sharedMutex);
+
+				if (!shared.empty()) {
+					task = shared.front();
+					shared.pop_front();
+					sharedSize.store((u32) shared.size(), std::memory_order_relaxed);
+				}
+			}
+
+			u32 n = (u32) queues.size();
+
+			for (u32 i = 1; i <= n && task == nullptr; ++i) {
+
+				u32 victim = (worker == u32_MAX ? i - 1 : worker + i) % n;
+
+				if (victim != worker)
+					task = queues[victim].steal();
+			}
+
+			if (task != nullptr)
+				queued.fetch_sub(1);
+
+			return task;
+		}
+
+		void work(u32 index) {
+
+			getWorkerId() = { this, index };
+
+			while (true) {
+
+				if (Task *task = find(index)) {
+					execute(task);
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(sleepMutex);
+
+				++sleeping;
+				sleepCondition.wait(lock, [this]() { return stop || queued.load() != 0; });
+				--sleeping;
+
+				if (stop)
+					return;
+			}
+		}
+
+		std::vector<TaskDeque> queues;
+		std::vector<std::thread> threads;
+
+		std::mutex sharedMutex;
+		std::deque<Task*> shared;
+		std::atomic<u32> sharedSize = { 0 };				//So finding work doesn't have to lock when it's empty
+
+		std::atomic<u32> queued = { 0 }, sleeping = { 0 };
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+		bool stop = false;
+
+	};
+
+	//Tasks with dependencies; can be run multiple times
+	class TaskGraph {
+
+	public:
+
+		//Returns the task, so it can be used in precede
+		template<typename F>
+		Task *add(F f) {
+			tasks.emplace_back(new FunctionTask<F>(std::move(f)));
+			return tasks.back().get();
+		}
+
+		//b can only run after a is done
+		void precede(Task *a, Task *b) { Task::precede(a, b); }
+
+		//Runs all tasks and waits for them
+		void run(TaskScheduler &scheduler = TaskScheduler::get()) {
+
+			std::vector<Task*> ptrs(tasks.size());
+
+			for (size_t i = 0; i < tasks.size(); ++i)
+				ptrs[i] = tasks[i].get();
+
+			scheduler.run(ptrs.data(), (u32) ptrs.size());
+		}
+
+		u32 size() const { return (u32) tasks.size(); }
+
+	private:
+
+		std::vector<std::unique_ptr<Task>> tasks;
+
+	};
+
 	class Thread {
 
 	public:
@@ -14,32 +512,18 @@ namespace oi {
 			return std::thread::hardware_concurrency();
 		}
 
+		//Calls f for every core on the global task scheduler; the calls aren't guaranteed to run at the same time
+		//If f throws, the first exception is rethrown once every call is done
 		template<typename T>
 		static std::vector<T> foreachCore(std::function<T (u32)> f) {
 
-			u32 threads = cores();
-			std::vector<std::future<T>> thr(threads);
-			std::vector<T> results(threads);
-
-			for (u32 i = 0; i < threads; ++i)
-				thr[i] = std::move(std::async(f, i));
-
-			for (u32 i = 0; i < threads; ++i)
-				results[i] = thr[i].get();
-
+			std::vector<T> results(cores());
+			TaskScheduler::get().parallelFor(0, cores(), [&](u32 i) { results[i] = f(i); }, 1);
 			return results;
 		}
 
 		static void foreachCore(std::function<void (u32)> f) {
-
-			u32 threads = cores();
-			std::vector<std::future<void>> thr(threads);
-
-			for (u32 i = 0; i < threads; ++i)
-				thr[i] = std::move(std::async(f, i));
-
-			for (u32 i = 0; i < threads; ++i)
-				thr[i].get();
+			TaskScheduler::get().parallelFor(0, cores(), [&](u32 i) { f(i); }, 1);
 		}
 
 	};
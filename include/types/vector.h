@@ -4,6 +4,7 @@
 #include "types/generic.h"
 #include "utils/log.h"
 #include "template/common.h"
+#include "types/simd.h"
 #include <cmath>
 #include <limits>
 
@@ -90,34 +91,22 @@ namespace oi {
 		}
 
 		TVec &operator+=(const TVec &other) {
-
-			for (u32 i = 0; i < n; ++i)
-				this->arr[i] += other.arr[i];
-
+			VecOps<T, n>::add(this->arr, other.arr);
 			return *this;
 		}
 
 		TVec &operator-=(const TVec &other) {
-
-			for (u32 i = 0; i < n; ++i)
-				this->arr[i] -= other.arr[i];
-
+			VecOps<T, n>::sub(this->arr, other.arr);
 			return *this;
 		}
 
 		TVec &operator/=(const TVec &other) {
-
-			for (u32 i = 0; i < n; ++i)
-				this->arr[i] /= other.arr[i];
-
+			VecOps<T, n>::div(this->arr, other.arr);
 			return *this;
 		}
 
 		TVec &operator*=(const TVec &other) {
-
-			for (u32 i = 0; i < n; ++i)
-				this->arr[i] *= other.arr[i];
-
+			VecOps<T, n>::mul(this->arr, other.arr);
 			return *this;
 		}
 
@@ -375,12 +364,7 @@ namespace oi {
 
 			static_assert(std::is_floating_point<T>::value && n >= 2, "TVec<T,n>::dot can only be performed on a floating point Vec2 and above");
 
-			T result = 0;
-
-			for (u32 i = 0; i < n; ++i)
-				result += this->arr[i] * v.arr[i];
-
-			return result;
+			return VecOps<T, n>::dot(this->arr, v.arr);
 		}
 
 		TVec cross(const TVec &other) {
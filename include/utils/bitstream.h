@@ -0,0 +1,271 @@
+#pragma once
+
+#include "types/generic.h"
+#include "utils/binaryhelper.h"
+#include <cstring>
+
+#ifdef _MSC_VER
+	#include <cstdlib>
+#endif
+
+namespace oi {
+
+	//Bit streams are most significant bit first; bit 0 is the high bit of byte 0
+	//Fields are 1-32 bits and are read and written through 64-bit words, instead of a bit at a time
+
+	class BitStream {
+
+	public:
+
+		//8 bytes as a big endian word; bytes past the end are read as 0
+		static u64 load(const u8 *ptr, const u8 *end) {
+
+			u64 word = 0;
+
+			if (end - ptr >= 8) {
+				memcpy(&word, ptr, 8);
+				return toBigEndian(word);
+			}
+
+			for (u32 i = 0; ptr + i < end; ++i)
+				word |= (u64) ptr[i] << (56 - i * 8);
+
+			return word;
+		}
+
+		static u64 toBigEndian(u64 word) {
+
+			if (!BinaryHelper::isLittleEndian)
+				return word;
+
+			#ifdef _MSC_VER
+				return _byteswap_uint64(word);
+			#else
+				return __builtin_bswap64(word);
+			#endif
+		}
+
+		static constexpr u32 mask(u32 bits) { return bits >= 32 ? u32_MAX : (1U << bits) - 1; }
+
+	};
+
+	class BitReader {
+
+	public:
+
+		BitReader(const u8 *data, u64 bytes) : data(data), end(data + bytes), length(bytes * 8) {}
+
+		//1-32 bits
+		u32 peek(u32 bits) const {
+			u64 word = BitStream::load(data + (position >> 3), end) << (position & 7);
+			return (u32)(word >> (64 - bits));
+		}
+
+		u32 read(u32 bits) {
+			u32 val = peek(bits);
+			position += bits;
+			return val;
+		}
+
+		bool readBit() { return read(1) != 0; }
+
+		void skip(u64 bits) { position += bits; }
+		void seek(u64 bit) { position = bit; }
+
+		u64 tell() const { return position; }
+		u64 remaining() const { return position >= length ? 0 : length - position; }
+
+		//Reading past the end returns zeros; this tells if that happened
+		bool overflowed() const { return position > length; }
+
+	private:
+
+		const u8 *data, *end;
+		u64 length, position = 0;
+
+	};
+
+	class BitWriter {
+
+	public:
+
+		BitWriter(u8 *data, u64 bytes) : data(data), capacity(bytes) {}
+
+		//Writes the low 'bits' (1-32) bits of val; returns false if it doesn't fit
+		bool write(u32 val, u32 bits) {
+
+			if (((written + fill + bits + 7) >> 3) > capacity)
+				return false;
+
+			acc = (acc << bits) | (val & BitStream::mask(bits));
+			fill += bits;
+
+			if (fill >= 32) {
+
+				fill -= 32;
+
+				u32 word = (u32)(acc >> fill);
+
+				data[(written >> 3)] = (u8)(word >> 24);
+				data[(written >> 3) + 1] = (u8)(word >> 16);
+				data[(written >> 3) + 2] = (u8)(word >> 8);
+				data[(written >> 3) + 3] = (u8) word;
+
+				written += 32;
+			}
+
+			return true;
+		}
+
+		bool writeBit(bool b) { return write(b ? 1 : 0, 1); }
+
+		//Writes the pending bits; the last byte is padded with zeros
+		void flush() {
+
+			while (fill >= 8) {
+				fill -= 8;
+				data[written >> 3] = (u8)(acc >> fill);
+				written += 8;
+			}
+
+			if (fill != 0) {
+				data[written >> 3] = (u8)(acc << (8 - fill));
+				written += fill;
+				fill = 0;
+			}
+		}
+
+		u64 tell() const { return written + fill; }
+		u64 getBytes() const { return (tell() + 7) >> 3; }
+
+	private:
+
+		u8 *data;
+		u64 capacity, written = 0;
+
+		u64 acc = 0;
+		u32 fill = 0;
+
+	};
+
+	//Batched fixed width symbols
+	//Up to 8 bits, a group of 8 symbols is exactly 'bits' bytes; so it's unpacked from a single word without tracking bit positions
+	class BitPacking {
+
+	public:
+
+		static u64 getBytes(u64 count, u32 bits) { return (count * bits + 7) >> 3; }
+
+		static void unpack(const u8 *src, u32 bits, u32 *dst, u64 count) {
+			unpack(src, bits, count, [dst](u64 i, u32 symbol) { dst[i] = symbol; return true; });
+		}
+
+		static void pack(const u32 *src, u32 bits, u8 *dst, u64 count) {
+			pack(dst, bits, count, [src](u64 i, u32 &symbol) { symbol = src[i]; return true; });
+		}
+
+		//Symbols are indices into the charset; returns false if one is out of bounds
+		static bool decode(const u8 *src, u32 bits, const char *charset, u32 charsetSize, char *dst, u64 count) {
+			return unpack(src, bits, count, [=](u64 i, u32 symbol) {
+				dst[i] = charset[symbol < charsetSize ? symbol : 0];
+				return symbol < charsetSize;
+			});
+		}
+
+		//Returns false if a character isn't in the charset (or its index doesn't fit in bits)
+		static bool encode(const char *str, u64 count, const char *charset, u32 charsetSize, u32 bits, u8 *dst) {
+
+			i32 lookup[256];
+
+			for (i32 &i : lookup)
+				i = -1;
+
+			for (u32 i = charsetSize; i > 0; --i)						//First occurrence wins
+				if (i - 1 <= BitStream::mask(bits))
+					lookup[(u8) charset[i - 1]] = (i32)(i - 1);
+
+			return pack(dst, bits, count, [&lookup, str](u64 i, u32 &symbol) {
+				i32 index = lookup[(u8) str[i]];
+				symbol = (u32) index;
+				return index >= 0;
+			});
+		}
+
+		//f(u64 i, u32 symbol) -> bool; stops if it returns false
+		template<typename F>
+		static bool unpack(const u8 *src, u32 bits, u64 count, F f) {
+
+			const u8 *end = src + getBytes(count, bits);
+			u64 i = 0;
+
+			if (bits <= 8) {
+
+				u32 m = BitStream::mask(bits);
+
+				for (; i + 8 <= count; i += 8) {
+
+					u64 word = BitStream::load(src + (i >> 3) * bits, end);
+
+					for (u32 j = 0; j < 8; ++j)
+						if (!f(i + j, (u32)(word >> (64 - bits * (j + 1))) & m))
+							return false;
+				}
+			}
+
+			BitReader reader(src, (u64)(end - src));
+			reader.seek(i * bits);
+
+			for (; i < count; ++i)
+				if (!f(i, reader.read(bits)))
+					return false;
+
+			return true;
+		}
+
+		//f(u64 i, u32 &symbol) -> bool; stops if it returns false
+		template<typename F>
+		static bool pack(u8 *dst, u32 bits, u64 count, F f) {
+
+			u64 i = 0;
+			u32 symbol;
+
+			if (bits <= 8) {
+
+				u32 m = BitStream::mask(bits);
+
+				for (; i + 8 <= count; i += 8) {
+
+					u64 word = 0;
+
+					for (u32 j = 0; j < 8; ++j) {
+
+						if (!f(i + j, symbol))
+							return false;
+
+						word = (word << bits) | (symbol & m);
+					}
+
+					u8 *out = dst + (i >> 3) * bits;
+
+					for (u32 j = 0; j < bits; ++j)
+						out[j] = (u8)(word >> ((bits - 1 - j) * 8));
+				}
+			}
+
+			BitWriter writer(dst + (i >> 3) * bits, getBytes(count - i, bits));
+
+			for (; i < count; ++i) {
+
+				if (!f(i, symbol))
+					return false;
+
+				writer.write(symbol, bits);
+			}
+
+			writer.flush();
+			return true;
+		}
+
+	};
+
+}
\ No newline at end of file
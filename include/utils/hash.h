@@ -0,0 +1,154 @@
+#pragma once
+
+#include "types/generic.h"
+#include "types/string.h"
+#include <string_view>
+#include <cstring>
+
+namespace oi {
+
+	//SHA-256 digest; used to content address data (like shader bytecode)
+	struct Hash256 {
+
+		u8 data[32];
+
+		bool operator==(const Hash256 &other) const { return memcmp(data, other.data, sizeof(data)) == 0; }
+		bool operator!=(const Hash256 &other) const { return !(*this == other); }
+
+		String toHex() const {
+
+			static constexpr char chars[] = "0123456789abcdef";
+
+			String res(64U, '0');
+
+			for (u32 i = 0; i < 32; ++i) {
+				res[i * 2] = chars[data[i] >> 4];
+				res[i * 2 + 1] = chars[data[i] & 0xF];
+			}
+
+			return res;
+		}
+
+	};
+
+	//FNV-1a hashing; used for precomputed name tables in the file formats
+	//Hashes are stored in files, so this function can't change without bumping the format versions
+	class Hash {
+
+	public:
+
+		static constexpr u32 offsetBasis = 0x811C9DC5U;
+		static constexpr u32 prime = 0x01000193U;
+
+		static constexpr u32 fnv1a(const char *str, size_t len, u32 hash = offsetBasis) {
+
+			for (size_t i = 0; i < len; ++i)
+				hash = (hash ^ (u8) str[i]) * prime;
+
+			return hash;
+		}
+
+		static constexpr u32 fnv1a(std::string_view str) {
+			return fnv1a(str.data(), str.size());
+		}
+
+		static Hash256 sha256(const u8 *dat, size_t len) {
+
+			static constexpr u32 k[64] = {
+				0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+				0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+				0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+				0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+				0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+				0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+				0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+				0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+			};
+
+			u32 h[8] = { 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 };
+
+			auto rotr = [](u32 x, u32 n) -> u32 { return (x >> n) | (x << (32 - n)); };
+
+			//Message + 0x80 + zero padding + 64-bit big endian bit length; processed per 64 byte block
+			size_t blocks = (len + 9 + 63) / 64;
+
+			for (size_t b = 0; b < blocks; ++b) {
+
+				u8 block[64];
+
+				for (size_t i = 0; i < 64; ++i) {
+
+					size_t j = b * 64 + i;
+
+					if (j < len) block[i] = dat[j];
+					else if (j == len) block[i] = 0x80;
+					else if (b == blocks - 1 && i >= 56) block[i] = (u8)(((u64) len * 8) >> ((63 - i) * 8));
+					else block[i] = 0;
+				}
+
+				u32 w[64];
+
+				for (u32 i = 0; i < 16; ++i)
+					w[i] = ((u32) block[i * 4] << 24) | ((u32) block[i * 4 + 1] << 16) | ((u32) block[i * 4 + 2] << 8) | block[i * 4 + 3];
+
+				for (u32 i = 16; i < 64; ++i) {
+					u32 s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+					u32 s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+					w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+				}
+
+				u32 a[8];
+				memcpy(a, h, sizeof(a));
+
+				for (u32 i = 0; i < 64; ++i) {
+
+					u32 s1 = rotr(a[4], 6) ^ rotr(a[4], 11) ^ rotr(a[4], 25);
+					u32 ch = (a[4] & a[5]) ^ (~a[4] & a[6]);
+					u32 t0 = a[7] + s1 + ch + k[i] + w[i];
+					u32 s0 = rotr(a[0], 2) ^ rotr(a[0], 13) ^ rotr(a[0], 22);
+					u32 maj = (a[0] & a[1]) ^ (a[0] & a[2]) ^ (a[1] & a[2]);
+					u32 t1 = s0 + maj;
+
+					memmove(a + 1, a, sizeof(u32) * 7);
+					a[4] += t0;
+					a[0] = t0 + t1;
+				}
+
+				for (u32 i = 0; i < 8; ++i)
+					h[i] += a[i];
+			}
+
+			Hash256 res;
+
+			for (u32 i = 0; i < 32; ++i)
+				res.data[i] = (u8)(h[i / 4] >> (24 - (i % 4) * 8));
+
+			return res;
+		}
+
+		//Open addressing table size for n elements; power of two with a load factor of at most 0.5
+		static constexpr u32 slots(u32 n) {
+
+			u32 i = 1;
+
+			while (i < n * 2)
+				i <<= 1;
+
+			return i;
+		}
+
+	};
+
+}
+
+//Hashing for Hash256
+namespace std {
+	template<>
+	struct hash<oi::Hash256> {
+		inline size_t operator()(const oi::Hash256 &h) const {
+			size_t res;
+			memcpy(&res, h.data, sizeof(res));
+			return res;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,345 @@
+#pragma once
+
+#include "types/string.h"
+#include "utils/hash.h"
+#include <memory>
+#include <tuple>
+#include <mutex>
+#include <shared_mutex>
+
+namespace oi {
+
+	//Interned string; the id is unique per string for the lifetime of the program
+	//Comparing and hashing symbols only touches the id, so they're meant as keys for tables that are looked up per frame
+	//The id isn't stable between runs, so it shouldn't be stored in files
+	class Symbol {
+
+	public:
+
+		Symbol() {}
+		explicit Symbol(StringRef name);
+
+		u32 getId() const { return id; }
+		bool isValid() const { return id != 0; }
+
+		StringRef getName() const;
+		String toString() const { return String(getName().toStdView()); }
+
+		bool operator==(Symbol other) const { return id == other.id; }
+		bool operator!=(Symbol other) const { return id != other.id; }
+		bool operator<(Symbol other) const { return id < other.id; }
+
+	private:
+
+		friend class SymbolTable;
+
+		Symbol(u32 id, const char *name) : id(id)
+		#ifdef _DEBUG
+		, name(name)
+		#endif
+		{ (void) name; }
+
+		u32 id = 0;
+
+		#ifdef _DEBUG
+		const char *name = "";			//So the debugger can show the text
+		#endif
+
+	};
+
+	//Global string interner; thread safe (lookups only take a shared lock)
+	//Interned names are never freed, so the StringRefs it returns stay valid
+	class SymbolTable {
+
+	public:
+
+		//Interns the name if it doesn't exist yet; an empty name is the invalid symbol
+		static Symbol get(StringRef name) {
+
+			if (name.empty())
+				return {};
+
+			SymbolTable &table = instance();
+			u32 hash = Hash::fnv1a(name.toStdView());
+
+			{
+				std::shared_lock<std::shared_mutex> lock(table.mutex);
+
+				if (u32 id = table.lookup(name, hash))
+					return Symbol(id, table.names[id - 1].data());
+			}
+
+			std::unique_lock<std::shared_mutex> lock(table.mutex);
+
+			if (u32 id = table.lookup(name, hash))								//Another thread could've added it in the meantime
+				return Symbol(id, table.names[id - 1].data());
+
+			return table.insert(name, hash);
+		}
+
+		//Returns the invalid symbol if the name was never interned
+		static Symbol find(StringRef name) {
+
+			if (name.empty())
+				return {};
+
+			SymbolTable &table = instance();
+
+			std::shared_lock<std::shared_mutex> lock(table.mutex);
+
+			u32 id = table.lookup(name, Hash::fnv1a(name.toStdView()));
+			return id == 0 ? Symbol() : Symbol(id, table.names[id - 1].data());
+		}
+
+		static StringRef getName(Symbol symbol) {
+
+			if (!symbol.isValid())
+				return {};
+
+			SymbolTable &table = instance();
+
+			std::shared_lock<std::shared_mutex> lock(table.mutex);
+			return table.names[symbol.id - 1];
+		}
+
+		static u32 size() {
+
+			SymbolTable &table = instance();
+
+			std::shared_lock<std::shared_mutex> lock(table.mutex);
+			return (u32) table.names.size();
+		}
+
+	private:
+
+		static constexpr u32 pageSize = 4096;
+
+		SymbolTable() : slots(Hash::slots(256)) {}
+
+		static SymbolTable &instance() {
+			static SymbolTable table;
+			return table;
+		}
+
+		//Returns the id or 0 if it doesn't exist
+		u32 lookup(StringRef name, u32 hash) const {
+
+			u32 mask = (u32) slots.size() - 1;
+
+			for (u32 i = hash & mask; slots[i] != 0; i = (i + 1) & mask)
+				if (hashes[slots[i] - 1] == hash && names[slots[i] - 1] == name)
+					return slots[i];
+
+			return 0;
+		}
+
+		Symbol insert(StringRef name, u32 hash) {
+
+			//Names are copied into pages, so they never move when the table grows
+			if (pages.empty() || pageUsed + name.size() + 1 > pageSize) {
+				pages.emplace_back(new char[name.size() + 1 > pageSize ? name.size() + 1 : pageSize]);
+				pageUsed = 0;
+			}
+
+			char *str = pages.back().get() + pageUsed;
+			memcpy(str, name.data(), name.size());
+			str[name.size()] = '\0';
+
+			pageUsed = name.size() + 1 > pageSize ? pageSize : pageUsed + name.size() + 1;
+
+			names.push_back(StringRef(str, name.size()));
+			hashes.push_back(hash);
+
+			u32 id = (u32) names.size();
+
+			if (id * 2 > (u32) slots.size()) {
+
+				slots.assign(Hash::slots(id), 0);
+
+				for (u32 j = 0; j < id; ++j)
+					place(hashes[j], j + 1);
+
+			} else
+				place(hash, id);
+
+			return Symbol(id, str);
+		}
+
+		void place(u32 hash, u32 id) {
+
+			u32 mask = (u32) slots.size() - 1, i = hash & mask;
+
+			while (slots[i] != 0)
+				i = (i + 1) & mask;
+
+			slots[i] = id;
+		}
+
+		std::shared_mutex mutex;
+
+		std::vector<StringRef> names;					//names[id - 1]
+		std::vector<u32> hashes;						//hashes[id - 1]
+		std::vector<u32> slots;							//Open addressing table of ids (0 = empty)
+
+		std::vector<std::unique_ptr<char[]>> pages;
+		u32 pageUsed = 0;
+
+	};
+
+	inline Symbol::Symbol(StringRef name) : Symbol(SymbolTable::get(name)) {}
+	inline StringRef Symbol::getName() const { return SymbolTable::getName(*this); }
+
+	//Flat hash map keyed by symbols; the elements are stored contiguously
+	//Iterates like std::unordered_map (elem.first, elem.second); but inserting or erasing invalidates iterators and references
+	template<typename T>
+	class SymbolMap {
+
+	public:
+
+		typedef std::pair<Symbol, T> value_type;
+		typedef value_type *iterator;
+		typedef const value_type *const_iterator;
+
+		iterator begin() { return entries.data(); }
+		iterator end() { return entries.data() + entries.size(); }
+		const_iterator begin() const { return entries.data(); }
+		const_iterator end() const { return entries.data() + entries.size(); }
+
+		u32 size() const { return (u32) entries.size(); }
+		bool empty() const { return entries.empty(); }
+
+		void clear() {
+			entries.clear();
+			slots.clear();
+		}
+
+		iterator find(Symbol key) {
+			u32 i = lookup(key);
+			return i == u32_MAX ? end() : begin() + slots[i] - 1;
+		}
+
+		const_iterator find(Symbol key) const {
+			u32 i = lookup(key);
+			return i == u32_MAX ? end() : begin() + slots[i] - 1;
+		}
+
+		//Doesn't intern the name; names that were never interned can't be in the map
+		iterator find(StringRef name) { return find(SymbolTable::find(name)); }
+		const_iterator find(StringRef name) const { return find(SymbolTable::find(name)); }
+
+		bool contains(Symbol key) const { return lookup(key) != u32_MAX; }
+		u32 count(Symbol key) const { return contains(key) ? 1 : 0; }
+
+		template<typename ...args>
+		std::pair<iterator, bool> emplace(Symbol key, args &&...arg) {
+
+			u32 i = lookup(key);
+
+			if (i != u32_MAX)
+				return { begin() + slots[i] - 1, false };
+
+			entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<args>(arg)...));
+
+			if (entries.size() * 2 > slots.size())
+				rehash();
+			else
+				place(key, (u32) entries.size());
+
+			return { end() - 1, true };
+		}
+
+		T &operator[](Symbol key) { return emplace(key).first->second; }
+
+		bool erase(Symbol key) {
+
+			u32 i = lookup(key);
+
+			if (i == u32_MAX)
+				return false;
+
+			u32 index = slots[i] - 1;
+			remove(i);
+
+			//Move the last element into the hole
+			if (index + 1 != (u32) entries.size()) {
+				entries[index] = std::move(entries.back());
+				slots[lookup(entries[index].first)] = index + 1;
+			}
+
+			entries.pop_back();
+			return true;
+		}
+
+	private:
+
+		//Sequential ids are spread over the table through Fibonacci hashing
+		static u32 home(Symbol key, u32 mask) { return (key.getId() * 0x9E3779B1U) & mask; }
+
+		//Returns the slot or u32_MAX
+		u32 lookup(Symbol key) const {
+
+			if (slots.empty())
+				return u32_MAX;
+
+			u32 mask = (u32) slots.size() - 1;
+
+			for (u32 i = home(key, mask); slots[i] != 0; i = (i + 1) & mask)
+				if (entries[slots[i] - 1].first == key)
+					return i;
+
+			return u32_MAX;
+		}
+
+		void place(Symbol key, u32 index) {
+
+			u32 mask = (u32) slots.size() - 1, i = home(key, mask);
+
+			while (slots[i] != 0)
+				i = (i + 1) & mask;
+
+			slots[i] = index;
+		}
+
+		void rehash() {
+
+			slots.assign(Hash::slots((u32) entries.size() < 8 ? 8 : (u32) entries.size()), 0);
+
+			for (u32 i = 0; i < (u32) entries.size(); ++i)
+				place(entries[i].first, i + 1);
+		}
+
+		//Backward shift deletion; keeps the probe sequences intact without tombstones
+		void remove(u32 i) {
+
+			u32 mask = (u32) slots.size() - 1;
+
+			for (u32 j = (i + 1) & mask; slots[j] != 0; j = (j + 1) & mask) {
+
+				u32 k = home(entries[slots[j] - 1].first, mask);
+
+				//Only move it if its home isn't in (i, j]
+				if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j)) {
+					slots[i] = slots[j];
+					i = j;
+				}
+			}
+
+			slots[i] = 0;
+		}
+
+		std::vector<value_type> entries;
+		std::vector<u32> slots;				//Index into entries + 1 (0 = empty)
+
+	};
+
+}
+
+//Hashing for Symbol
+namespace std {
+	template<>
+	struct hash<oi::Symbol> {
+		inline size_t operator()(oi::Symbol symbol) const {
+			return symbol.getId();
+		}
+	};
+}
\ No newline at end of file
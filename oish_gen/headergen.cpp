@@ -0,0 +1,239 @@
+#include "headergen.h"
+#include "spirvformat.h"
+#include <utils/log.h>
+
+using namespace oi;
+using namespace oi::gc;
+using namespace spirv_cross;
+
+HeaderGenerator::HeaderGenerator(String shaderName) : shaderName(toIdentifier(shaderName)) {}
+
+String HeaderGenerator::toIdentifier(String name) {
+
+	String res = name;
+
+	for (u32 i = 0; i < res.size(); ++i)
+		if (!isalnum((u8) res[i]) && res[i] != '_')
+			res[i] = '_';
+
+	if (res.size() == 0 || isdigit((u8) res[0]))
+		res = String("_") + res;
+
+	return res;
+}
+
+//Type of a scalar, vector or matrix column; returns an empty string if it isn't supported
+String getScalarType(const SPIRType &type) {
+
+	switch (type.basetype) {
+
+	case SPIRType::BaseType::Half:
+		return "u16";
+
+	case SPIRType::BaseType::Float:
+		return "f32";
+
+	case SPIRType::BaseType::Double:
+		return "f64";
+
+	case SPIRType::BaseType::Int:
+		return "i32";
+
+	case SPIRType::BaseType::Boolean:
+	case SPIRType::BaseType::UInt:
+		return "u32";
+
+	case SPIRType::BaseType::Int64:
+		return "i64";
+
+	case SPIRType::BaseType::UInt64:
+		return "u64";
+
+	default:
+		return "";
+
+	}
+
+}
+
+String HeaderGenerator::getStructName(Compiler &comp, u32 typeId, String memberName) {
+
+	const SPIRType &type = comp.get_type(typeId);
+
+	auto it = structNames.find(type.self);
+
+	if (it != structNames.end())
+		return it->second;
+
+	String name = comp.get_name(type.self);
+
+	if (name == "")
+		name = memberName + "_t";
+
+	name = toIdentifier(name);
+
+	//Avoid clashing with other structs (of the same name)
+	for (auto &elem : structNames)
+		if (elem.second == name)
+			name = name + "_" + type.self;
+
+	structNames[type.self] = name;
+	structs.push_back(emitStruct(comp, type.self, name));
+
+	return name;
+}
+
+String HeaderGenerator::emitStruct(Compiler &comp, u32 typeId, String name, String extra) {
+
+	const SPIRType &type = comp.get_type(typeId);
+
+	String members, constants, asserts;
+
+	u32 cursor = 0, padding = 0;
+
+	for (u32 i = 0; i < (u32) type.member_types.size(); ++i) {
+
+		const SPIRType &mem = comp.get_type(type.member_types[i]);
+
+		String memName = toIdentifier(comp.get_member_name(type.self, i));
+		u32 offset = comp.type_struct_member_offset(type, i);
+
+		if (offset < cursor)
+			Log::throwError<HeaderGenerator, 0x0>(String("Member ") + name + "::" + memName + " overlaps the previous member");
+
+		if (offset > cursor) {
+			members += String("\t\t\tu8 padding") + padding + "[" + (offset - cursor) + "];\n";
+			++padding;
+		}
+
+		constants += String("\t\t\tstatic constexpr u32 ") + memName + "_offset = " + offset + ";\n";
+
+		String elemType;
+		u32 elemSize;
+
+		if (mem.basetype == SPIRType::Struct) {
+			elemType = getStructName(comp, type.member_types[i], memName);
+			elemSize = (u32) comp.get_declared_struct_size(mem);
+		} else {
+
+			String scalar = getScalarType(mem);
+
+			if (scalar == "")
+				Log::throwError<HeaderGenerator, 0x1>(String("Member ") + name + "::" + memName + " has an unsupported type");
+
+			//Row major matrices are stored as rows; so they're emitted transposed (as TMatrix<T, rows, columns>)
+			SPIRMemberLayout layout = getMemberLayout(comp, type, i);
+
+			u32 scalarSize = mem.width / 8;
+			u32 vecSize = layout.components * scalarSize;
+
+			elemType = layout.components == 1 ? scalar : String("oi::TVec<") + scalar + ", " + layout.components + ">";
+			elemSize = vecSize;
+
+			if (mem.columns > 1) {
+
+				if (layout.stride == vecSize)
+					elemType = String("oi::TMatrix<") + scalar + ", " + layout.vectors + ", " + layout.components + ">";
+				else {
+
+					if (layout.stride % scalarSize != 0)
+						Log::throwError<HeaderGenerator, 0x2>(String("Member ") + name + "::" + memName + " has an unsupported matrix stride");
+
+					elemType = String("std::array<oi::TVec<") + scalar + ", " + (layout.stride / scalarSize) + ">, " + layout.vectors + ">";
+				}
+
+				elemSize = layout.stride * layout.vectors;
+
+				if (layout.rowMajor)
+					constants += String("\t\t\tstatic constexpr bool ") + memName + "_rowMajor = true;\n";
+			}
+
+			constants += String("\t\t\tstatic constexpr oi::gc::TextureFormat_s ") + memName + "_format = oi::gc::TextureFormat::" + layout.format.getName() + ";\n";
+		}
+
+		String dims;
+
+		if (mem.array.size() != 0) {
+
+			for (u32 j = 0; j < (u32) mem.array.size(); ++j)
+				if (mem.array[j] == 0 || !mem.array_size_literal[j])
+					Log::throwError<HeaderGenerator, 0x3>(String("Member ") + name + "::" + memName + " is a runtime or specialization sized array; which isn't supported");
+
+			u32 stride = comp.type_struct_member_array_stride(type, i);
+
+			//Stride of the innermost dimension; outer dimensions have to be their inner dimension without padding, since only the element can be padded
+			u32 id = type.member_types[i], elemStride = stride;
+
+			for (u32 j = (u32) mem.array.size() - 1; j > 0; --j) {
+
+				id = comp.get_type(id).parent_type;
+				u32 inner = comp.get_decoration(id, spv::DecorationArrayStride);
+
+				if (inner * mem.array[j - 1] != elemStride)
+					Log::throwError<HeaderGenerator, 0x4>(String("Member ") + name + "::" + memName + " has padding between the dimensions of its array; which isn't supported");
+
+				elemStride = inner;
+			}
+
+			if (elemStride < elemSize)
+				Log::throwError<HeaderGenerator, 0x5>(String("Member ") + name + "::" + memName + " has an array stride that is smaller than its element");
+
+			//Elements that don't match the array stride are padded (in every dimension)
+			if (elemStride != elemSize) {
+
+				String elemName = toIdentifier(name + "_" + memName + "_element");
+				structs.push_back(String("\t\tstruct ") + elemName + " {\n\t\t\t" + elemType + " value;\n\t\t\tu8 padding[" + (elemStride - elemSize) + "];\n\t\t};\n\n\t\tstatic_assert(sizeof(" + elemName + ") == " + elemStride + ", \"" + elemName + " doesn't match the shader layout\");\n");
+
+				elemType = elemName;
+			}
+
+			for (u32 j = (u32) mem.array.size(); j > 0; --j)
+				dims += String("[") + mem.array[j - 1] + "]";
+
+			constants += String("\t\t\tstatic constexpr u32 ") + memName + "_stride = " + stride + ";\n";
+		}
+
+		members += String("\t\t\t") + elemType + " " + memName + dims + ";\n";
+		asserts += String("\t\tstatic_assert(offsetof(") + name + ", " + memName + ") == " + offset + ", \"" + name + "::" + memName + " doesn't match the shader layout\");\n";
+
+		cursor = offset + (u32) comp.get_declared_struct_member_size(type, i);
+	}
+
+	u32 size = (u32) comp.get_declared_struct_size(type);
+
+	if (size > cursor)
+		members += String("\t\t\tu8 padding") + padding + "[" + (size - cursor) + "];\n";
+
+	asserts += String("\t\tstatic_assert(sizeof(") + name + ") == " + size + ", \"" + name + " doesn't match the shader layout\");\n";
+
+	return String("\t\tstruct ") + name + " {\n\n" + extra + constants + "\n" + members + "\n\t\t};\n\n" + asserts;
+}
+
+void HeaderGenerator::addBuffer(Compiler &comp, u32 typeId, String name, u32 binding) {
+
+	String id = toIdentifier(name);
+
+	if (buffers.find(id) != buffers.end())
+		return;
+
+	buffers.insert(id);
+
+	String extra = String("\t\t\tstatic constexpr u32 bufferBinding = ") + binding + ";\n\t\t\tstatic constexpr const char *bufferName = \"" + name + "\";\n\n";
+
+	structNames[comp.get_type(typeId).self] = id;
+	structs.push_back(emitStruct(comp, typeId, id, extra));
+}
+
+String HeaderGenerator::generate() const {
+
+	String res = String("//Generated by oish_gen for ") + shaderName + "; don't modify\n#pragma once\n\n";
+	res += String("#include <types/matrix.h>") + "\n#include <graphics/texture.h>\n#include <array>\n#include <cstddef>\n\n";
+	res += String("namespace oish {") + "\n\n\tnamespace " + shaderName + " {\n\n";
+
+	for (const String &str : structs)
+		res += str + "\n";
+
+	res += String("\t}") + "\n\n}";
+
+	return res;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "spirv_cross.h"
+#include <types/string.h>
+#include <unordered_set>
+
+namespace oi {
+
+	namespace gc {
+
+		//Generates a C++ header with POD structs for the buffers of a shader
+		//Members are placed at the reflected (std140/std430) offsets through explicit padding and verified with static_asserts
+		//Every member also gets a constexpr offset (and format if it isn't a struct); so uniforms can be written without lookups
+		class HeaderGenerator {
+
+		public:
+
+			HeaderGenerator(String shaderName);
+
+			//Adds a uniform/storage buffer; buffers that were already added by another stage are skipped
+			void addBuffer(spirv_cross::Compiler &comp, u32 typeId, String name, u32 binding);
+
+			String generate() const;
+
+			static String toIdentifier(String name);
+
+		private:
+
+			String emitStruct(spirv_cross::Compiler &comp, u32 typeId, String name, String extra = "");
+			String getStructName(spirv_cross::Compiler &comp, u32 typeId, String memberName);
+
+			String shaderName;
+
+			std::vector<String> structs;
+			std::unordered_set<String> buffers;
+			std::unordered_map<u32, String> structNames;
+
+		};
+
+	}
+
+}
\ No newline at end of file
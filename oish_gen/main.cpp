@@ -1,11 +1,17 @@
 #include "spirv_cross.h"
+#include "headergen.h"
+#include "spirvformat.h"
 #include <utils/log.h>
-#include <graphics/format/oish.h>
+#include <graphics/format/oisx.h>
+#include <graphics/format/spvcompact.h>
 #include <graphics/shader.h>
 #include <graphics/shaderstage.h>
 #include <graphics/graphics.h>
 
 #include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <random>
 
 #pragma comment(lib, "Xinput.lib")
 
@@ -32,85 +38,162 @@ ShaderStageType pickExtension(String &s) {
 //Modifies 'varName' into the name that isn't prefixed
 Vec2u getBufferInfo(String &varName) {
 
-	std::vector<String> split = varName.split("_");
+	StringRef name = varName;
+	u32 split = name.findFirst('_');
 
-	if (split.size() == 0) return Vec2u(0, 0);
-	
-	String &start = split[0];
+	StringRef start = name.cutEnd(split);
+	StringRef rest = name.cutBegin(split == u32_MAX ? name.size() : split + 1);
 
-	if (start.startsWith("i")) {
+	u32 buffer;
 
-		if (start == "i") {
-			varName = varName.cutBegin(2);	//remove i_
-			return Vec2u(0, 1);
-		}
+	if (start.startsWith("i") || start.startsWith("a")) {
 
-		start = start.cutBegin(1);
+		u32 isInstanced = start[0] == 'i' ? 1U : 0U;
 
-		if (start.isUint()) {
-			split.erase(split.begin());
-			varName = String::combine(split, "_");	//remove i<x>_
-			return Vec2u((u32)start.toLong(), 1U);
-		}
-
-	} 
-	else if(start.startsWith("a")){
-
-		if (start == "a") {
-			varName = varName.cutBegin(2);	//remove a_
-			return Vec2u(0, 0);
+		//remove i_ or a_
+		if (start.size() == 1) {
+			varName = String(rest);
+			return Vec2u(0, isInstanced);
 		}
 
 		start = start.cutBegin(1);
 
-		if (start.isUint()) {
-			split.erase(split.begin());
-			varName = String::combine(split, "_");	//remove a<x>_
-			return Vec2u((u32)start.toLong(), 0U);
+		//remove i<x>_ or a<x>_
+		if (start.toUint(buffer)) {
+			varName = String(rest);
+			return Vec2u(buffer, isInstanced);
 		}
 
 	} 
-	else if(start.isUint())
-		return Vec2u((u32) start.toLong(), 0U);
+	else if(start.toUint(buffer))
+		return Vec2u(buffer, 0U);
 
 	return Vec2u(0, 0);
 }
 
-TextureFormat getFormat(SPIRType type) {
+//Which ids an instruction starts with; used to delta encode result ids in SPVCompact
+//Unlisted ops have a result type and result id
+SPVCompactLayout getLayout(u16 op) {
+
+	switch ((spv::Op) op) {
+
+	case spv::OpNop:
+	case spv::OpSourceContinued:
+	case spv::OpSource:
+	case spv::OpSourceExtension:
+	case spv::OpName:
+	case spv::OpMemberName:
+	case spv::OpLine:
+	case spv::OpNoLine:
+	case spv::OpExtension:
+	case spv::OpMemoryModel:
+	case spv::OpEntryPoint:
+	case spv::OpExecutionMode:
+	case spv::OpCapability:
+	case spv::OpTypeForwardPointer:
+	case spv::OpFunctionEnd:
+	case spv::OpStore:
+	case spv::OpCopyMemory:
+	case spv::OpCopyMemorySized:
+	case spv::OpDecorate:
+	case spv::OpMemberDecorate:
+	case spv::OpGroupDecorate:
+	case spv::OpGroupMemberDecorate:
+	case spv::OpImageWrite:
+	case spv::OpEmitVertex:
+	case spv::OpEndPrimitive:
+	case spv::OpEmitStreamVertex:
+	case spv::OpEndStreamPrimitive:
+	case spv::OpControlBarrier:
+	case spv::OpMemoryBarrier:
+	case spv::OpAtomicStore:
+	case spv::OpAtomicFlagClear:
+	case spv::OpLoopMerge:
+	case spv::OpSelectionMerge:
+	case spv::OpBranch:
+	case spv::OpBranchConditional:
+	case spv::OpSwitch:
+	case spv::OpKill:
+	case spv::OpReturn:
+	case spv::OpReturnValue:
+	case spv::OpUnreachable:
+	case spv::OpLifetimeStart:
+	case spv::OpLifetimeStop:
+	case spv::OpGroupWaitEvents:
+	case spv::OpCommitReadPipe:
+	case spv::OpCommitWritePipe:
+	case spv::OpGroupCommitReadPipe:
+	case spv::OpGroupCommitWritePipe:
+	case spv::OpRetainEvent:
+	case spv::OpReleaseEvent:
+	case spv::OpSetUserEventStatus:
+	case spv::OpCaptureEventProfilingInfo:
+	case spv::OpMemoryNamedBarrier:
+		return SPVCompactLayout::NONE;
+
+	case spv::OpString:
+	case spv::OpExtInstImport:
+	case spv::OpTypeVoid:
+	case spv::OpTypeBool:
+	case spv::OpTypeInt:
+	case spv::OpTypeFloat:
+	case spv::OpTypeVector:
+	case spv::OpTypeMatrix:
+	case spv::OpTypeImage:
+	case spv::OpTypeSampler:
+	case spv::OpTypeSampledImage:
+	case spv::OpTypeArray:
+	case spv::OpTypeRuntimeArray:
+	case spv::OpTypeStruct:
+	case spv::OpTypeOpaque:
+	case spv::OpTypePointer:
+	case spv::OpTypeFunction:
+	case spv::OpTypeEvent:
+	case spv::OpTypeDeviceEvent:
+	case spv::OpTypeReserveId:
+	case spv::OpTypeQueue:
+	case spv::OpTypePipe:
+	case spv::OpTypePipeStorage:
+	case spv::OpTypeNamedBarrier:
+	case spv::OpDecorationGroup:
+	case spv::OpLabel:
+		return SPVCompactLayout::RESULT;
 
-	switch (type.basetype) {
+	default:
+		return SPVCompactLayout::RESULT_TYPE;
 
-	case SPIRType::BaseType::Half:
-		return TextureFormat::R16f - (type.vecsize - 1);
+	}
 
-	case SPIRType::BaseType::Float:
-		return TextureFormat::R32f - (type.vecsize - 1);
+}
 
-	case SPIRType::BaseType::UInt:
-		return TextureFormat::R32u - (type.vecsize - 1);
+//Re-encode optimized SPIR-V as SPVCompact; the instruction stream and round trip are validated before it is used
+UniqueBuffer compactSpirv(const UniqueBuffer &spirv) {
 
-	case SPIRType::BaseType::Int:
-		return TextureFormat::R32i - (type.vecsize - 1);
+	if (spirv.size() % 4 != 0 || spirv.size() < 20)
+		Log::throwError<SPVCompact, 0x0>("SPIRV bytecode incorrect");
 
-	case SPIRType::BaseType::UInt64:
-		return TextureFormat::R64u - (type.vecsize - 1);
+	std::vector<uint32_t> words((const u32*) spirv.addr(), (const u32*)(spirv.addr() + spirv.size()));
 
-	case SPIRType::BaseType::Double:
-		return TextureFormat::R64f - (type.vecsize - 1);
+	if (words[0] != spv::MagicNumber)
+		Log::throwError<SPVCompact, 0x1>("SPIRV magic number incorrect");
 
-	case SPIRType::BaseType::Boolean:
-	case SPIRType::BaseType::Char:
-		return TextureFormat::R32u;
+	//Walk the instructions; throws if they are empty or out of bounds
+	for (uint32_t offset = 5; offset < (uint32_t) words.size(); )
+		Instruction inst(words, offset);
 
-	default:
-		return TextureFormat::Undefined;
+	UniqueBuffer compact = SPVCompact::encode(words.data(), (u32) words.size(), getLayout);
 
-	}
+	std::vector<u32> decoded;
+
+	if (!SPVCompact::decode(compact.view(), decoded) || decoded != words)
+		Log::throwError<SPVCompact, 0x2>("SPVCompact round trip didn't match the SPIRV bytecode");
 
+	Log::println(String("Compacted SPIRV from ") + spirv.size() + " to " + compact.size() + " bytes");
 
+	return compact;
 }
 
-void fillStruct(Compiler &comp, u32 id, ShaderBufferInfo &info, ShaderBufferObject *var) {
+void fillStruct(Compiler &comp, u32 id, ShaderBufferInfo &info, ShaderBufferObject *var, std::vector<SBPath> &paths, String path = "", u32 base = 0U) {
 
 	auto &type = comp.get_type(id);
 	
@@ -125,55 +208,213 @@ void fillStruct(Compiler &comp, u32 id, ShaderBufferInfo &info, ShaderBufferObje
 
 		u32 varId = var == &info.self ? 0U : (u32)(var - info.elements.data()) + 1U;
 
-		if (mem.basetype == SPIRType::Struct) {
+		//Arrays are flattened; specialization constant sizes use their default and a runtime array has size 0 (unbounded)
+		u32 arraySize = 1U;
+
+		for (u32 j = 0; j < (u32) mem.array.size(); ++j)
+			arraySize *= mem.array_size_literal[j] ? mem.array[j] : comp.get_constant(mem.array[j]).scalar();
+
+		//The array stride is of the outer dimension; inner dimensions are tightly packed in it
+		u32 stride = 0U;
+
+		if (mem.array.size() != 0) {
 
-			u32 size = (u32)comp.get_declared_struct_member_size(mem, i);
+			u32 inner = 1U;
 
-			obj.length = size;
-			obj.arraySize = mem.array.size() == 0 ? 1U : (u32) mem.array[0];
+			for (u32 j = 0; j + 1 < (u32) mem.array.size(); ++j)
+				inner *= mem.array_size_literal[j] ? mem.array[j] : comp.get_constant(mem.array[j]).scalar();
+
+			stride = comp.type_struct_member_array_stride(type, i) / inner;
+		}
+
+		SBPath sbpath = {};
+		String memPath = path == "" ? obj.name : path + "/" + obj.name;
+
+		sbpath.hash = Hash::fnv1a(memPath.toCString(), memPath.size());
+		sbpath.offset = base + obj.offset;
+		sbpath.arraySize = arraySize;
+
+		if (mem.basetype == SPIRType::Struct) {
+
+			obj.length = (u32) comp.get_declared_struct_size(mem);
+			obj.arraySize = arraySize;
 			obj.format = TextureFormat::Undefined;
 
+			sbpath.length = obj.length;
+			sbpath.stride = stride == 0 ? obj.length : stride;
+			sbpath.flags = (u8) SBPathFlag::IS_STRUCT;
+
 			u32 objoff = (u32) info.elements.size();
 
 			info.push(obj, *var);
 			var = varId == 0 ? &info.self : info.elements.data() + varId - 1U;
 
-			fillStruct(comp, type.member_types[i], info, info.elements.data() + objoff);
+			sbpath.element = (u16) info.elements.size();
+			paths.push_back(sbpath);
+
+			fillStruct(comp, type.member_types[i], info, info.elements.data() + objoff, paths, memPath, sbpath.offset);
 
 		} else {
 
-			obj.format = getFormat(mem);
-			obj.arraySize = mem.columns;
+			SPIRMemberLayout layout = getMemberLayout(comp, type, i);
+
+			if (layout.format == TextureFormat::Undefined)
+				Log::throwError<ShaderBufferInfo, 0x0>(String("Unsupported member type for ") + obj.name);
+
+			//Matrices are stored as columns, or rows if they're RowMajor; every vector is an element
+			obj.format = layout.format;
+			obj.arraySize = layout.vectors * arraySize;
 			obj.length = Graphics::getFormatSize(obj.format);
 
+			sbpath.length = layout.vectors > 1 ? layout.stride * layout.vectors : obj.length;
+			sbpath.stride = stride == 0 ? sbpath.length : stride;
+			sbpath.type = (u8) obj.format.getValue();
+
 			info.push(obj, *var);
 			var = varId == 0 ? &info.self : info.elements.data() + varId - 1U;
+
+			sbpath.element = (u16) info.elements.size();
+			paths.push_back(sbpath);
 		}
 	}
 
 }
 
+//Adds the bytes (of the members) that a stage accesses; coalesced per stage
+void addActiveRanges(Compiler &comp, u32 id, ShaderRegisterAccess stage, std::vector<SBActiveRange> &ranges) {
+
+	std::vector<BufferRange> active = comp.get_active_buffer_ranges(id);
+
+	std::sort(active.begin(), active.end(), [](const BufferRange &a, const BufferRange &b) -> bool { return a.offset < b.offset; });
+
+	u32 first = (u32) ranges.size();
+
+	for (BufferRange &r : active) {
+
+		u32 start = (u32) r.offset, end = (u32)(r.offset + r.range);
+
+		if ((u32) ranges.size() > first && start <= ranges.back().offset + ranges.back().size) {
+			ranges.back().size = std::max(ranges.back().size, end - ranges.back().offset);
+			continue;
+		}
+
+		SBActiveRange range = {};
+		range.offset = start;
+		range.size = end - start;
+		range.stage = (u8) stage.getValue();
+		ranges.push_back(range);
+	}
+}
+
+//Warns about the members of a buffer that no stage accesses
+void warnDeadMembers(const ShaderBufferInfo &info, const SXBuffer &refl) {
+
+	for (ShaderBufferObject *obj : info.self.childs) {
+
+		u32 start = obj->offset, end = u32_MAX, offset;
+
+		//Runtime arrays (arraySize 0) extend to the end of the buffer; its size is only known at runtime
+		const SBPath *p = oiSB::findPath(refl.paths, std::string_view(obj->name.toCString(), obj->name.size()), offset);
+
+		if (p != nullptr && p->arraySize != 0)
+			end = start + (p->arraySize - 1) * p->stride + p->length;
+
+		bool used = false;
+
+		for (const SBActiveRange &range : refl.activeRanges)
+			used |= range.offset < end && range.offset + range.size > start;
+
+		if (!used)
+			Log::warn(String("Member ") + info.self.name + "/" + obj->name + " isn't used by any stage");
+	}
+}
+
+//Writes to a unique temporary file and renames it; so readers never see a partially written file
+bool writeAtomic(String path, Buffer data) {
+
+	String temp = path + "." + (u32) std::random_device()() + ".tmp";
+
+	std::ofstream out(temp.toCString(), std::ios::binary);
+
+	if (!out.good()) return Log::error(String("Couldn't open ") + temp);
+
+	out.write((char*) data.addr(), data.size());
+	out.close();
+
+	std::error_code err;
+
+	if (out.fail()) {
+		std::filesystem::remove(temp.toCString(), err);
+		return Log::error(String("Couldn't write ") + temp);
+	}
+
+	std::filesystem::rename(temp.toCString(), path.toCString(), err);
+
+	if (err) {
+		std::filesystem::remove(temp.toCString(), err);
+		return Log::error(String("Couldn't replace ") + path);
+	}
+
+	return true;
+}
+
 int main(int argc, char *argv[]) {
 
 	String path, shaderName;
 	std::vector<String> extensions;
+	bool compact = false, header = false;
+	String storePath;
+	std::vector<Hash256> storedHashes;
+	std::vector<UniqueBuffer> stageCode;			//Owns the code the stage infos point to
 
-	if (argc < 4) return (int) Log::error("Incorrect usage: oish_gen.exe <pathToShader> <shaderName> [shaderStage extensions]");
+	if (argc < 4) return (int) Log::error("Incorrect usage: oish_gen.exe <pathToShader> <shaderName> [shaderStage extensions] [-compact] [-header] [-store <directory>]");
 
 	path = argv[1];
 	shaderName = argv[2];
 	
-	for (int i = 3; i < argc; ++i)
-		extensions.push_back(argv[i]);
+	for (int i = 3; i < argc; ++i) {
+
+		String arg = argv[i];
+
+		if (arg == "-compact")
+			compact = true;
+		else if (arg == "-header")
+			header = true;
+		else if (arg == "-store") {
+
+			if (i + 1 == argc || String(argv[i + 1]).startsWith("-"))
+				return (int) Log::error("Incorrect usage: -store requires a directory");
+
+			storePath = argv[++i];
+
+			if (!storePath.endsWith("/") && !storePath.endsWith("\\"))
+				storePath += "/";
+		}
+		else
+			extensions.push_back(arg);
+	}
+
+	if (compact && storePath == "")
+		return (int) Log::error("Incorrect usage: -compact only applies to the stage store (-store <directory>)");
 
 	ShaderInfo info;
 	info.path = shaderName;
 
+	//Reflection that oiSH can't store (oiSX)
+	std::unordered_map<String, SXBuffer> reflection;
+	SXBuffer pushReflection;
+
+	ShaderBufferInfo pushConstants;					//Only used if pushConstantAccess isn't Undefined
+	ShaderRegisterAccess pushConstantAccess = ShaderRegisterAccess::Undefined;
+	std::vector<ShaderSpecConstant> specConstants;
+
 	std::vector<ShaderStageInfo> &stageInfo = info.stages;
 	stageInfo.resize(extensions.size());
 
 	std::vector<String> names = { shaderName };
 
+	HeaderGenerator headerGen(shaderName);
+
 	u32 j = 0, k = 0;
 
 	//Open the extensions' spirv and parse their data
@@ -187,18 +428,18 @@ int main(int argc, char *argv[]) {
 
 		if (!str.good()) return (int)Log::error("Couldn't open that file");
 
-		u32 length = (u32)str.rdbuf()->pubseekoff(0, std::ios_base::end);
+		u64 length = (u64) str.rdbuf()->pubseekoff(0, std::ios_base::end);
 
-		Buffer b(length);
+		UniqueBuffer b(length);
 		str.seekg(0, std::ios::beg);
-		str.read((char*)b.addr(), b.size());
+		str.read((char*)b.addr(), (std::streamsize) b.size());
 
 		str.close();
 
 		if (b.size() % 4 != 0)
 			Log::throwError<VkNull, 0x0>("SPIRV bytecode incorrect");
 
-		std::vector<uint32_t> bytecode((u32*)b.addr(), (u32*)(b.addr() + b.size()));
+		std::vector<uint32_t> bytecode((const u32*) b.addr(), (const u32*)(b.addr() + b.size()));
 		Compiler comp(move(bytecode));
 
 		ShaderResources res = comp.get_shader_resources();
@@ -274,22 +515,39 @@ int main(int argc, char *argv[]) {
 			String name = String(r.name).replaceLast("_ext", "");
 
 			info.bufferIds[k] = name;
-			ShaderBufferInfo &dat = info.buffer[name];
-
 			const SPIRType &btype = comp.get_type(r.base_type_id);
 
-			dat.size = (u32) comp.get_declared_struct_size(btype);
-			dat.allocate = String(r.name).endsWithIgnoreCase("_ext");
-			dat.type = reg.type;
+			//Buffers shared between stages only have to be reflected once
+			auto it = info.buffer.find(name);
 
-			dat.self.arraySize = 1U;
-			dat.self.length = dat.size;
-			dat.self.format = TextureFormat::Undefined;
-			dat.self.name = name;
-			dat.self.offset = 0U;
-			dat.self.parent = nullptr;
+			if (it == info.buffer.end()) {
+
+				ShaderBufferInfo &dat = info.buffer[name];
+
+				dat.size = (u32) comp.get_declared_struct_size(btype);
+				dat.allocate = String(r.name).endsWithIgnoreCase("_ext");
+				dat.type = reg.type;
+
+				dat.self.arraySize = 1U;
+				dat.self.length = dat.size;
+				dat.self.format = TextureFormat::Undefined;
+				dat.self.name = name;
+				dat.self.offset = 0U;
+				dat.self.parent = nullptr;
+
+				std::vector<SBPath> paths;
+				fillStruct(comp, r.base_type_id, dat, &dat.self, paths);
+
+				reflection[name].size = dat.size;
+
+				if (!oiSB::makePaths(paths, reflection[name].paths))
+					return (int)Log::error(String("Couldn't create the path table of ") + name);
+
+				if (header)
+					headerGen.addBuffer(comp, r.base_type_id, name, binding);
+			}
 
-			fillStruct(comp, r.base_type_id, dat, &dat.self);
+			addActiveRanges(comp, r.id, stageAccess, reflection[name].activeRanges);
 
 			++i;
 			++k;
@@ -338,7 +596,60 @@ int main(int argc, char *argv[]) {
 
 		}
 
-		b.deconstruct();
+		//Push constants; the stages share the block, so it's only reflected once
+		for (Resource &r : res.push_constant_buffers) {
+
+			if (pushConstantAccess == ShaderRegisterAccess::Undefined) {
+
+				ShaderBufferInfo &dat = pushConstants;
+
+				dat.size = (u32) comp.get_declared_struct_size(comp.get_type(r.base_type_id));
+				dat.allocate = false;
+				dat.type = ShaderRegisterType::Undefined;
+
+				dat.self.arraySize = 1U;
+				dat.self.length = dat.size;
+				dat.self.format = TextureFormat::Undefined;
+				dat.self.name = r.name;
+				dat.self.offset = 0U;
+				dat.self.parent = nullptr;
+
+				std::vector<SBPath> paths;
+				fillStruct(comp, r.base_type_id, dat, &dat.self, paths);
+
+				pushReflection.size = dat.size;
+
+				if (!oiSB::makePaths(paths, pushReflection.paths))
+					return (int)Log::error(String("Couldn't create the path table of ") + r.name);
+			}
+
+			pushConstantAccess = pushConstantAccess.getValue() | stageAccess.getValue();
+			addActiveRanges(comp, r.id, stageAccess, pushReflection.activeRanges);
+		}
+
+		//Specialization constants (scalars); stages that use the same id share it
+		for (const SpecializationConstant &sc : comp.get_specialization_constants()) {
+
+			bool exists = false;
+
+			for (ShaderSpecConstant &spec : specConstants)
+				exists |= spec.id == sc.constant_id;
+
+			if (exists)
+				continue;
+
+			const SPIRConstant &constant = comp.get_constant(sc.id);
+			const SPIRType &ctype = comp.get_type(constant.constant_type);
+
+			TextureFormat format = getFormat(ctype);
+
+			if (format == TextureFormat::Undefined || ctype.vecsize != 1 || ctype.columns != 1)
+				return (int)Log::error(String("Unsupported specialization constant type for ") + comp.get_name(sc.id));
+
+			u64 value = ctype.width == 64 ? (u64) constant.scalar_u64() : (u64) constant.scalar();
+
+			specConstants.push_back(ShaderSpecConstant(sc.constant_id, format, comp.get_name(sc.id), value));
+		}
 
 		//Load optimized spirv
 
@@ -346,29 +657,100 @@ int main(int argc, char *argv[]) {
 
 		if (!ospv.good()) return (int) Log::error("Couldn't open that file");
 
-		length = (u32) ospv.rdbuf()->pubseekoff(0, std::ios_base::end);
+		length = (u64) ospv.rdbuf()->pubseekoff(0, std::ios_base::end);
 
-		b = Buffer(length);
+		b = UniqueBuffer(length);
 		ospv.seekg(0, std::ios::beg);
-		ospv.read((char*)b.addr(), b.size());
-		stageInfo[j] = { b, type };
+		ospv.read((char*)b.addr(), (std::streamsize) b.size());
 		ospv.close();
 
+		//Content address the code; the oiSH file keeps its own copy, so it still loads without the store
+		if (storePath != "") {
+
+			//Compact SPIR-V is only written to the store; the oiSH v0_0_1 loader can't decode it
+			UniqueBuffer compacted;
+
+			if (compact)
+				compacted = compactSpirv(b);
+
+			Buffer stored = compact ? compacted.view() : b.view();
+
+			Hash256 hash = Hash::sha256(stored.addr(), stored.size());
+			String storeFile = storePath + hash.toHex() + ".ospv";
+
+			if (!std::ifstream(storeFile.toCString(), std::ios::binary).good() && !writeAtomic(storeFile, stored))
+				return (int)Log::error(String("Couldn't write to the stage store ") + storeFile);
+
+			storedHashes.push_back(hash);
+		}
+
+		stageInfo[j] = { b.view(), type };
+		stageCode.push_back(std::move(b));
+
 		++j;
 	}
 
-	Buffer b = oiSH::write(oiSH::convert(info));
+	for (auto &elem : info.buffer)
+		warnDeadMembers(elem.second, reflection[elem.first]);
 
-	std::ofstream oish((path + ".oiSH").toCString(), std::ios::binary);
+	if (pushConstantAccess != ShaderRegisterAccess::Undefined)
+		warnDeadMembers(pushConstants, pushReflection);
 
-	if (!oish.good()) return (int)Log::error("Couldn't open that file");
-	
-	oish.write((char*)b.addr(), b.size());
-	oish.close();
+	//Buffers are stored in bufferIds order; pointers into the map stay valid while info is moved into the SHFile
+	std::vector<const SXBuffer*> bufferReflection(info.bufferIds.size());
+
+	for (auto &id : info.bufferIds)
+		bufferReflection[id.first] = &reflection[id.second];
+
+	SHFile file = oiSH::convert(std::move(info));
+
+	//Reflection that oiSH can't store goes into the oiSX file; it uses the oiSH string list, so it's built first
+	SXFile sxfile;
 
+	//Copied; a buffer can be used by multiple stages
+	for (u32 i = 0; i < (u32) file.buffers.size() && i < (u32) bufferReflection.size(); ++i)
+		sxfile.buffers.push_back(*bufferReflection[i]);
+
+	if (pushConstantAccess != ShaderRegisterAccess::Undefined) {
+		sxfile.pushConstants = oiSB::convert(std::move(pushConstants), &file.stringlist);
+		sxfile.pushConstantPaths = std::move(pushReflection);
+		sxfile.header.pushConstants = (u8) pushConstantAccess.getValue();
+	}
+
+	for (ShaderSpecConstant &spec : specConstants) {
+		sxfile.specConstants.push_back(SXSpecConstant(spec.id, (u16) file.stringlist.names.size(), (u8) spec.type.getValue(), spec.value));
+		file.stringlist.names.push_back(spec.name);
+	}
+
+	sxfile.codeHashes = std::move(storedHashes);
+
+	Buffer b = oiSH::write(file);
+	bool written = b.size() != 0 && writeAtomic(path + ".oiSH", b);
 	b.deconstruct();
 
+	if (!written)
+		return (int)Log::error("Couldn't write the oiSH file");
+
+	UniqueBuffer sx(oiSX::getSize(sxfile));
+
+	if (oiSX::write(sxfile, sx.view()) == 0 || !writeAtomic(path + ".oiSX", sx.view()))
+		return (int)Log::error("Couldn't write the oiSX file");
+
 	Log::println(String("Successfully converted to ") + path + ".oiSH");
 
+	if (header) {
+
+		String headerStr = headerGen.generate();
+
+		std::ofstream oishh((path + ".oiSH.h").toCString(), std::ios::binary);
+
+		if (!oishh.good()) return (int)Log::error("Couldn't open that file");
+
+		oishh.write(headerStr.toCString(), headerStr.size());
+		oishh.close();
+
+		Log::println(String("Successfully generated ") + path + ".oiSH.h");
+	}
+
 	return 1U;
 }
\ No newline at end of file
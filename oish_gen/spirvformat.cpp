@@ -0,0 +1,58 @@
+#include "spirvformat.h"
+
+using namespace oi;
+using namespace oi::gc;
+using namespace spirv_cross;
+
+//Format of a scalar, vector or matrix column; indexed by SPIRType::BaseType and vecsize - 1
+static constexpr TextureFormat_s formatTable[][4] = {
+	{ TextureFormat::Undefined, TextureFormat::Undefined, TextureFormat::Undefined, TextureFormat::Undefined },		//Unknown
+	{ TextureFormat::Undefined, TextureFormat::Undefined, TextureFormat::Undefined, TextureFormat::Undefined },		//Void
+	{ TextureFormat::R32u, TextureFormat::RG32u, TextureFormat::RGB32u, TextureFormat::RGBA32u },					//Boolean (32-bit in buffers)
+	{ TextureFormat::R8u, TextureFormat::RG8u, TextureFormat::RGB8u, TextureFormat::RGBA8u },						//Char
+	{ TextureFormat::R32i, TextureFormat::RG32i, TextureFormat::RGB32i, TextureFormat::RGBA32i },					//Int
+	{ TextureFormat::R32u, TextureFormat::RG32u, TextureFormat::RGB32u, TextureFormat::RGBA32u },					//UInt
+	{ TextureFormat::R64i, TextureFormat::RG64i, TextureFormat::RGB64i, TextureFormat::RGBA64i },					//Int64
+	{ TextureFormat::R64u, TextureFormat::RG64u, TextureFormat::RGB64u, TextureFormat::RGBA64u },					//UInt64
+	{ TextureFormat::Undefined, TextureFormat::Undefined, TextureFormat::Undefined, TextureFormat::Undefined },		//AtomicCounter
+	{ TextureFormat::R16f, TextureFormat::RG16f, TextureFormat::RGB16f, TextureFormat::RGBA16f },					//Half
+	{ TextureFormat::R32f, TextureFormat::RG32f, TextureFormat::RGB32f, TextureFormat::RGBA32f },					//Float
+	{ TextureFormat::R64f, TextureFormat::RG64f, TextureFormat::RGB64f, TextureFormat::RGBA64f }					//Double
+};
+
+TextureFormat oi::gc::getFormat(const SPIRType &type) {
+
+	if ((u32) type.basetype >= (u32)(sizeof(formatTable) / sizeof(formatTable[0])) || type.vecsize - 1 >= 4 || type.columns - 1 >= 4)
+		return TextureFormat::Undefined;
+
+	return formatTable[type.basetype][type.vecsize - 1];
+}
+
+SPIRMemberLayout oi::gc::getMemberLayout(Compiler &comp, const SPIRType &parent, u32 member) {
+
+	const SPIRType &type = comp.get_type(parent.member_types[member]);
+
+	SPIRMemberLayout layout = { 1U, type.vecsize, 0U, false, getFormat(type) };
+
+	if (type.columns <= 1)
+		return layout;
+
+	layout.stride = comp.type_struct_member_matrix_stride(parent, member);
+	layout.rowMajor = comp.has_member_decoration(parent.self, member, spv::DecorationRowMajor);
+
+	if (!layout.rowMajor) {
+		layout.vectors = type.columns;
+		return layout;
+	}
+
+	//A row has a component per column
+	SPIRType row = type;
+	row.vecsize = type.columns;
+	row.columns = 1;
+
+	layout.vectors = type.vecsize;
+	layout.components = type.columns;
+	layout.format = getFormat(row);
+
+	return layout;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "spirv_cross.h"
+#include <graphics/texture.h>
+
+namespace oi {
+
+	namespace gc {
+
+		//Returns the format of one column (Undefined if it isn't a scalar, vector or matrix with 1-4 components/columns)
+		TextureFormat getFormat(const spirv_cross::SPIRType &type);
+
+		//How a (matrix) member of a struct is stored; 'vectors' vectors of 'components' that are 'stride' bytes apart
+		//Column major matrices store their columns, RowMajor matrices their rows; other types are a single vector
+		struct SPIRMemberLayout {
+
+			u32 vectors, components, stride;
+			bool rowMajor;
+
+			TextureFormat format;		//Format of one stored vector
+
+		};
+
+		SPIRMemberLayout getMemberLayout(spirv_cross::Compiler &comp, const spirv_cross::SPIRType &parent, u32 member);
+
+	}
+
+}
\ No newline at end of file